@@ -168,7 +168,8 @@ module_entry(
                "rotator/sde_rotator_r1_pipe.c ",
                "rotator/sde_rotator_r1_ctl.c",
                "rotator/sde_rotator_r1.c",
-               "rotator/sde_rotator_r3.c"],
+               "rotator/sde_rotator_r3.c",
+               "rotator/sde_rotator_sw.c"],
             "CONFIG_SYNC_FILE":["rotator/sde_rotator_sync.c"],
             "CONFIG_DEBUG_FS":["rotator/sde_rotator_debug.c",
                               "rotator/sde_rotator_r1_debug.c",
@@ -0,0 +1,97 @@
+/* SPDX-License-Identifier: GPL-2.0-only WITH Linux-syscall-note */
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef _SDE_DBG_LOG_H_
+#define _SDE_DBG_LOG_H_
+
+#include <linux/types.h>
+
+/*
+ * Binary snapshot of the sde event log and register log, exported through
+ * the evtlog_bin and reglog_bin debugfs nodes. The snapshot can be read or
+ * mmap'ed read-only and is laid out as:
+ *
+ *   struct sde_dbg_log_header
+ *   record_count records of record_size bytes at record_offset
+ *   string table of strtab_size bytes at strtab_offset
+ *
+ * Strings in the string table are NUL terminated and referenced by byte
+ * offset. Event log records are grouped per cpu ring, sort them by time to
+ * recover the global order.
+ */
+
+#define SDE_DBG_LOG_MAGIC	0x53444c47 /* "SDLG" */
+#define SDE_DBG_LOG_VERSION	1
+
+#define SDE_DBG_LOG_TYPE_EVTLOG	1
+#define SDE_DBG_LOG_TYPE_REGLOG	2
+
+#define SDE_DBG_LOG_MAX_DATA	15
+
+/**
+ * struct sde_dbg_log_header - binary log snapshot header
+ * @magic: SDE_DBG_LOG_MAGIC
+ * @version: SDE_DBG_LOG_VERSION
+ * @type: SDE_DBG_LOG_TYPE_* of the records which follow
+ * @record_size: size in bytes of one record
+ * @record_count: number of records
+ * @record_offset: byte offset of the first record
+ * @strtab_offset: byte offset of the string table
+ * @strtab_size: size in bytes of the string table
+ */
+struct sde_dbg_log_header {
+	__u32 magic;
+	__u32 version;
+	__u32 type;
+	__u32 record_size;
+	__u32 record_count;
+	__u32 record_offset;
+	__u32 strtab_offset;
+	__u32 strtab_size;
+};
+
+/**
+ * struct sde_dbg_evtlog_record - one event log entry
+ * @time: local clock timestamp in ns
+ * @name_offset: string table offset of the logging function name
+ * @line: line number of the call site
+ * @pid: pid of the logging task
+ * @cpu: cpu the entry was logged on
+ * @index: index of the entry within its cpu ring
+ * @data_cnt: number of valid words in @data
+ * @data: logged data words
+ * @reserved: reserved, zero
+ */
+struct sde_dbg_evtlog_record {
+	__s64 time;
+	__u32 name_offset;
+	__u32 line;
+	__s32 pid;
+	__u32 cpu;
+	__u32 index;
+	__u32 data_cnt;
+	__u32 data[SDE_DBG_LOG_MAX_DATA];
+	__u32 reserved;
+};
+
+/**
+ * struct sde_dbg_reglog_record - one register log entry
+ * @time: local clock timestamp in ns
+ * @pid: pid of the writing task
+ * @addr: register offset
+ * @val: value written
+ * @blk_id: register block id
+ * @reserved: reserved, zero
+ */
+struct sde_dbg_reglog_record {
+	__s64 time;
+	__u32 pid;
+	__u32 addr;
+	__u32 val;
+	__u8 blk_id;
+	__u8 reserved[3];
+};
+
+#endif /* _SDE_DBG_LOG_H_ */
@@ -177,4 +177,10 @@ struct msm_sde_rotator_comp_ratio {
  */
 #define V4L2_CID_SDE_ROTATOR_SECURE_CAMERA	(V4L2_CID_USER_BASE + 0x2000)
 
+/*
+ * This control Id sets the maximum number of ready source/destination
+ * buffer pairs the driver may coalesce into one hardware request.
+ */
+#define V4L2_CID_SDE_ROTATOR_BATCH_DEPTH	(V4L2_CID_USER_BASE + 0x3000)
+
 #endif /* __UAPI_MSM_SDE_ROTATOR_H__ */
@@ -15,10 +15,16 @@
 #include "dp_aux.h"
 #include "dp_hpd.h"
 #include "dp_debug.h"
+#include "sde_trace.h"
 
 #define DP_AUX_ENUM_STR(x)		#x
 #define DP_AUX_IPC_NUM_PAGES 10
 
+#define DP_AUX_CACHE_LINE		16
+#define DP_AUX_CACHE_RANGE_SIZE		0x100
+#define DP_AUX_CACHE_SIZE		(2 * DP_AUX_CACHE_RANGE_SIZE)
+#define DP_AUX_CACHE_LINES		(DP_AUX_CACHE_SIZE / DP_AUX_CACHE_LINE)
+
 #define DP_AUX_DEBUG(dp_aux, fmt, ...) \
 	do { \
 		if (dp_aux) \
@@ -94,6 +100,25 @@ struct dp_aux_private {
 	int switch_orientation;
 
 	atomic_t aborted;
+
+	ssize_t (*transfer)(struct drm_dp_aux *drm_aux,
+			struct drm_dp_aux_msg *msg);
+
+	spinlock_t cache_lock;
+	u32 cache_gen;
+	DECLARE_BITMAP(cache_valid, DP_AUX_CACHE_LINES);
+	u8 cache[DP_AUX_CACHE_SIZE];
+};
+
+/*
+ * Read-only capability ranges which can only change across an HPD or
+ * IRQ_HPD: receiver, DSC and FEC capabilities and the extended receiver
+ * capability field. Each range occupies DP_AUX_CACHE_RANGE_SIZE bytes of
+ * the cache, in table order.
+ */
+static const u32 dp_aux_cache_ranges[] = {
+	DP_DPCD_REV,
+	DP_DP13_DPCD_REV,
 };
 
 static void dp_aux_hex_dump(struct drm_dp_aux *drm_aux,
@@ -364,6 +389,7 @@ static void dp_aux_reconfig(struct dp_aux *dp_aux)
 
 	aux->catalog->update_aux_cfg(aux->catalog,
 			aux->cfg, PHY_AUX_CFG1);
+	dp_aux->stats.cfg1_rotations++;
 	aux->catalog->reset(aux->catalog);
 }
 
@@ -525,6 +551,60 @@ error:
 	return ret;
 }
 
+static void dp_aux_update_stats(struct dp_aux_private *aux,
+		struct drm_dp_aux_msg *msg, int ret, ktime_t start)
+{
+	struct dp_aux_stats *stats = &aux->dp_aux.stats;
+	u32 latency_us = ktime_us_delta(ktime_get(), start);
+	int aux_err = aux->aux_error_num;
+	int type, bucket;
+
+	if (aux->native)
+		type = aux->read ? DP_AUX_XFER_NATIVE_READ :
+				DP_AUX_XFER_NATIVE_WRITE;
+	else
+		type = aux->read ? DP_AUX_XFER_I2C_READ :
+				DP_AUX_XFER_I2C_WRITE;
+
+	stats->count[type]++;
+	stats->total_us[type] += latency_us;
+	stats->max_us[type] = max(stats->max_us[type], latency_us);
+
+	for (bucket = 0; bucket < DP_AUX_LAT_BUCKETS - 1; bucket++) {
+		if (latency_us < DP_AUX_LAT_BUCKET_US(bucket))
+			break;
+	}
+	stats->lat_hist[type][bucket]++;
+
+	/* aux_error_num is stale if the sink never replied */
+	if (ret == -ETIMEDOUT)
+		aux_err = DP_AUX_ERR_TOUT;
+
+	switch (aux_err) {
+	case DP_AUX_ERR_ADDR:
+		stats->addr_err++;
+		break;
+	case DP_AUX_ERR_TOUT:
+		stats->timeout++;
+		break;
+	case DP_AUX_ERR_NACK:
+		stats->nack++;
+		break;
+	case DP_AUX_ERR_DEFER:
+	case DP_AUX_ERR_NACK_DEFER:
+		stats->defer++;
+		break;
+	case DP_AUX_ERR_PHY:
+		stats->phy_err++;
+		break;
+	default:
+		break;
+	}
+
+	trace_sde_dp_aux_xfer(msg->request, msg->address, msg->size, ret,
+			aux_err, latency_us);
+}
+
 static inline bool dp_aux_is_sideband_msg(u32 address, size_t size)
 {
 	return (address >= 0x1000 && address + size < 0x1800) ||
@@ -541,6 +621,7 @@ static ssize_t dp_aux_transfer(struct drm_dp_aux *drm_aux,
 {
 	ssize_t ret;
 	int const retry_count = 5;
+	ktime_t start;
 	struct dp_aux_private *aux = container_of(drm_aux,
 		struct dp_aux_private, drm_aux);
 
@@ -555,12 +636,16 @@ static ssize_t dp_aux_transfer(struct drm_dp_aux *drm_aux,
 		goto unlock_exit;
 	}
 
+	start = ktime_get();
 	ret = dp_aux_cmd_fifo_tx(aux, msg);
 	if ((ret < 0) && !atomic_read(&aux->aborted)) {
+		dp_aux_update_stats(aux, msg, ret, start);
 		aux->retry_cnt++;
-		if (!(aux->retry_cnt % retry_count))
+		if (!(aux->retry_cnt % retry_count)) {
 			aux->catalog->update_aux_cfg(aux->catalog,
 				aux->cfg, PHY_AUX_CFG1);
+			aux->dp_aux.stats.cfg1_rotations++;
+		}
 		aux->catalog->reset(aux->catalog);
 		goto unlock_exit;
 	} else if (ret < 0) {
@@ -571,11 +656,15 @@ static ssize_t dp_aux_transfer(struct drm_dp_aux *drm_aux,
 		if (aux->read)
 			dp_aux_cmd_fifo_rx(aux, msg);
 
+		dp_aux_update_stats(aux, msg, ret, start);
+
 		dp_aux_hex_dump(drm_aux, msg);
 
 		msg->reply = aux->native ?
 			DP_AUX_NATIVE_REPLY_ACK : DP_AUX_I2C_REPLY_ACK;
 	} else {
+		dp_aux_update_stats(aux, msg, ret, start);
+
 		/* Reply defer to retry */
 		msg->reply = aux->native ?
 			DP_AUX_NATIVE_REPLY_DEFER : DP_AUX_I2C_REPLY_DEFER;
@@ -643,6 +732,171 @@ end:
 	return size;
 }
 
+static bool dp_aux_cache_offset(u32 address, size_t size, u32 *offset)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(dp_aux_cache_ranges); i++) {
+		u32 base = dp_aux_cache_ranges[i];
+
+		if (address >= base &&
+				address + size <= base + DP_AUX_CACHE_RANGE_SIZE) {
+			*offset = (i * DP_AUX_CACHE_RANGE_SIZE) + address - base;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool dp_aux_cache_lookup(struct dp_aux_private *aux, u32 offset,
+		struct drm_dp_aux_msg *msg)
+{
+	u32 line, last = (offset + msg->size - 1) / DP_AUX_CACHE_LINE;
+	bool hit = true;
+
+	spin_lock(&aux->cache_lock);
+	for (line = offset / DP_AUX_CACHE_LINE; line <= last; line++) {
+		if (!test_bit(line, aux->cache_valid)) {
+			hit = false;
+			break;
+		}
+	}
+
+	if (hit)
+		memcpy(msg->buffer, aux->cache + offset, msg->size);
+	spin_unlock(&aux->cache_lock);
+
+	if (hit)
+		msg->reply = DP_AUX_NATIVE_REPLY_ACK;
+
+	return hit;
+}
+
+/*
+ * Fetch every missing cache line covered by the request as a full 16 byte
+ * AUX burst. Lines fetched while an invalidation raced with the transfer
+ * are discarded. Returns false if any burst was not acked so the caller can
+ * fall back to the uncached transfer and its defer/retry handling.
+ */
+static bool dp_aux_cache_fill(struct dp_aux_private *aux, u32 address,
+		u32 offset, size_t size)
+{
+	u8 buf[DP_AUX_CACHE_LINE];
+	struct drm_dp_aux_msg burst;
+	u32 line, last = (offset + size - 1) / DP_AUX_CACHE_LINE;
+	u32 gen;
+	ssize_t ret;
+
+	for (line = offset / DP_AUX_CACHE_LINE; line <= last; line++) {
+		if (test_bit(line, aux->cache_valid))
+			continue;
+
+		memset(&burst, 0, sizeof(burst));
+		burst.address = address - offset + (line * DP_AUX_CACHE_LINE);
+		burst.request = DP_AUX_NATIVE_READ;
+		burst.buffer = buf;
+		burst.size = sizeof(buf);
+
+		spin_lock(&aux->cache_lock);
+		gen = aux->cache_gen;
+		spin_unlock(&aux->cache_lock);
+
+		ret = aux->transfer(&aux->drm_aux, &burst);
+		if (ret != sizeof(buf) || (burst.reply & DP_AUX_NATIVE_REPLY_MASK)
+				!= DP_AUX_NATIVE_REPLY_ACK)
+			return false;
+
+		spin_lock(&aux->cache_lock);
+		if (gen == aux->cache_gen) {
+			memcpy(aux->cache + (line * DP_AUX_CACHE_LINE), buf,
+					sizeof(buf));
+			__set_bit(line, aux->cache_valid);
+		}
+		spin_unlock(&aux->cache_lock);
+	}
+
+	return true;
+}
+
+static void dp_aux_cache_drop(struct dp_aux_private *aux, u32 offset,
+		size_t size)
+{
+	u32 line, last = (offset + size - 1) / DP_AUX_CACHE_LINE;
+
+	spin_lock(&aux->cache_lock);
+	aux->cache_gen++;
+	for (line = offset / DP_AUX_CACHE_LINE; line <= last; line++)
+		__clear_bit(line, aux->cache_valid);
+	spin_unlock(&aux->cache_lock);
+}
+
+/*
+ * Outermost transfer hook. Native reads which fall entirely within a
+ * static capability range are served from the DPCD cache, everything else
+ * is handed to the transfer function selected for the current bridge/sim
+ * configuration. Nested transfers issued by a bridge bypass the cache.
+ *
+ * The 1-byte DP_DPCD_REV read always goes to the sink, drm_dp_dpcd_read()
+ * issues it to wake the sink up. Any write to DP_SET_POWER drops the whole cache
+ * since the sink may reload its capabilities across a power state change.
+ */
+static ssize_t dp_aux_cache_transfer(struct drm_dp_aux *drm_aux,
+		struct drm_dp_aux_msg *msg)
+{
+	struct dp_aux_private *aux = container_of(drm_aux,
+			struct dp_aux_private, drm_aux);
+	u32 offset;
+
+	if (msg->request == DP_AUX_NATIVE_WRITE &&
+			msg->address <= DP_SET_POWER &&
+			msg->address + msg->size > DP_SET_POWER)
+		dp_aux_cache_drop(aux, 0, DP_AUX_CACHE_SIZE);
+
+	if (!aux->dp_aux.dpcd_cache_en || !msg->size ||
+			(msg->address == DP_DPCD_REV && msg->size == 1) ||
+			aux->bridge_in_transfer || aux->sim_in_transfer ||
+			!dp_aux_cache_offset(msg->address, msg->size, &offset))
+		return aux->transfer(drm_aux, msg);
+
+	if (msg->request == DP_AUX_NATIVE_WRITE) {
+		dp_aux_cache_drop(aux, offset, msg->size);
+		return aux->transfer(drm_aux, msg);
+	}
+
+	if (msg->request != DP_AUX_NATIVE_READ)
+		return aux->transfer(drm_aux, msg);
+
+	if (dp_aux_cache_lookup(aux, offset, msg)) {
+		aux->dp_aux.dpcd_cache_hits++;
+		return msg->size;
+	}
+
+	aux->dp_aux.dpcd_cache_misses++;
+	if (dp_aux_cache_fill(aux, msg->address, offset, msg->size) &&
+			dp_aux_cache_lookup(aux, offset, msg))
+		return msg->size;
+
+	return aux->transfer(drm_aux, msg);
+}
+
+static void dp_aux_dpcd_cache_invalidate(struct dp_aux *dp_aux)
+{
+	struct dp_aux_private *aux;
+
+	if (!dp_aux) {
+		DP_AUX_ERR(dp_aux, "invalid input\n");
+		return;
+	}
+
+	aux = container_of(dp_aux, struct dp_aux_private, dp_aux);
+
+	spin_lock(&aux->cache_lock);
+	aux->cache_gen++;
+	bitmap_zero(aux->cache_valid, DP_AUX_CACHE_LINES);
+	spin_unlock(&aux->cache_lock);
+}
+
 static void dp_aux_reset_phy_config_indices(struct dp_aux_cfg *aux_cfg)
 {
 	int i = 0;
@@ -691,6 +945,8 @@ static void dp_aux_deinit(struct dp_aux *dp_aux)
 	atomic_set(&aux->aborted, 1);
 	aux->catalog->enable(aux->catalog, false);
 	aux->enabled = false;
+
+	dp_aux_dpcd_cache_invalidate(dp_aux);
 }
 
 static int dp_aux_register(struct dp_aux *dp_aux, struct drm_device *drm_dev)
@@ -708,7 +964,8 @@ static int dp_aux_register(struct dp_aux *dp_aux, struct drm_device *drm_dev)
 
 	aux->drm_aux.name = "sde_dp_aux";
 	aux->drm_aux.dev = aux->dev;
-	aux->drm_aux.transfer = dp_aux_transfer;
+	aux->drm_aux.transfer = dp_aux_cache_transfer;
+	aux->transfer = dp_aux_transfer;
 #if (KERNEL_VERSION(5, 15, 0) <= LINUX_VERSION_CODE)
 	aux->drm_aux.drm_dev = drm_dev;
 #endif
@@ -722,7 +979,7 @@ static int dp_aux_register(struct dp_aux *dp_aux, struct drm_device *drm_dev)
 
 	/* if bridge is defined, override transfer function */
 	if (aux->aux_bridge && aux->aux_bridge->transfer)
-		aux->drm_aux.transfer = dp_aux_bridge_transfer;
+		aux->transfer = dp_aux_bridge_transfer;
 exit:
 	return ret;
 }
@@ -758,14 +1015,17 @@ static void dp_aux_set_sim_mode(struct dp_aux *dp_aux,
 
 	if (sim_bridge) {
 		atomic_set(&aux->aborted, 0);
-		aux->drm_aux.transfer = dp_aux_transfer_debug;
+		aux->transfer = dp_aux_transfer_debug;
 	} else if (aux->aux_bridge && aux->aux_bridge->transfer) {
-		aux->drm_aux.transfer = dp_aux_bridge_transfer;
+		aux->transfer = dp_aux_bridge_transfer;
 	} else {
-		aux->drm_aux.transfer = dp_aux_transfer;
+		aux->transfer = dp_aux_transfer;
 	}
 
 	mutex_unlock(&aux->mutex);
+
+	/* the simulated sink exposes different capabilities */
+	dp_aux_dpcd_cache_invalidate(dp_aux);
 }
 
 #if IS_ENABLED(CONFIG_QCOM_FSA4480_I2C)
@@ -912,6 +1172,7 @@ struct dp_aux *dp_aux_get(struct device *dev, struct dp_catalog_aux *catalog,
 	init_completion(&aux->comp);
 	aux->cmd_busy = false;
 	mutex_init(&aux->mutex);
+	spin_lock_init(&aux->cache_lock);
 
 	aux->dev = dev;
 	aux->catalog = catalog;
@@ -930,6 +1191,8 @@ struct dp_aux *dp_aux_get(struct device *dev, struct dp_catalog_aux *catalog,
 	dp_aux->reconfig = dp_aux_reconfig;
 	dp_aux->abort = dp_aux_abort_transaction;
 	dp_aux->set_sim_mode = dp_aux_set_sim_mode;
+	dp_aux->dpcd_cache_invalidate = dp_aux_dpcd_cache_invalidate;
+	dp_aux->dpcd_cache_en = true;
 	dp_aux->ipc_log_context = ipc_log_context;
 
 #if IS_ENABLED(CONFIG_QCOM_FSA4480_I2C)
@@ -40,11 +40,57 @@ enum dp_aux_error {
 	DP_AUX_ERR_PHY	= -6,
 };
 
+#define DP_AUX_LAT_BUCKETS	8
+#define DP_AUX_LAT_BUCKET_US(i)	(100 << (i))
+
+enum dp_aux_xfer_type {
+	DP_AUX_XFER_NATIVE_READ,
+	DP_AUX_XFER_NATIVE_WRITE,
+	DP_AUX_XFER_I2C_READ,
+	DP_AUX_XFER_I2C_WRITE,
+	DP_AUX_XFER_MAX,
+};
+
+/**
+ * struct dp_aux_stats - AUX channel transaction statistics
+ * @count: transactions issued, per transfer type
+ * @total_us: accumulated transaction latency, per transfer type
+ * @max_us: worst transaction latency, per transfer type
+ * @lat_hist: latency histogram per transfer type, bucket i counts
+ *            transactions below DP_AUX_LAT_BUCKET_US(i), the last bucket
+ *            counts everything slower
+ * @defer: transactions the sink replied to with DEFER
+ * @nack: transactions the sink replied to with NACK
+ * @timeout: transactions which timed out waiting for a reply
+ * @addr_err: transactions which failed with a wrong address
+ * @phy_err: transactions which failed with a PHY error
+ * @cfg1_rotations: PHY_AUX_CFG1 settings tried after repeated failures
+ */
+struct dp_aux_stats {
+	u32 count[DP_AUX_XFER_MAX];
+	u64 total_us[DP_AUX_XFER_MAX];
+	u32 max_us[DP_AUX_XFER_MAX];
+	u32 lat_hist[DP_AUX_XFER_MAX][DP_AUX_LAT_BUCKETS];
+	u32 defer;
+	u32 nack;
+	u32 timeout;
+	u32 addr_err;
+	u32 phy_err;
+	u32 cfg1_rotations;
+};
+
 struct dp_aux {
 	u32 state;
 
 	bool read;
 
+	/* static DPCD capability cache, invalidated on every HPD/IRQ_HPD */
+	bool dpcd_cache_en;
+	u32 dpcd_cache_hits;
+	u32 dpcd_cache_misses;
+
+	struct dp_aux_stats stats;
+
 	struct mutex *access_lock;
 	void *ipc_log_context;
 
@@ -57,6 +103,7 @@ struct dp_aux {
 	void (*reconfig)(struct dp_aux *aux);
 	void (*abort)(struct dp_aux *aux, bool abort);
 	void (*set_sim_mode)(struct dp_aux *aux, struct dp_aux_bridge *sim_bridge);
+	void (*dpcd_cache_invalidate)(struct dp_aux *aux);
 	int (*switch_configure)(struct dp_aux *aux, bool enable, int orientation);
 	int (*switch_register_notifier)(struct notifier_block *nb, struct device_node *node);
 	int (*switch_unregister_notifier)(struct notifier_block *nb, struct device_node *node);
@@ -7,6 +7,7 @@
 #include <linux/types.h>
 #include <linux/completion.h>
 #include <linux/delay.h>
+#include <linux/crc32.h>
 #include <drm/drm_fixed.h>
 #include <linux/version.h>
 
@@ -45,6 +46,8 @@
 
 #define DP_MAX_LANES 4
 
+#define DP_CTRL_LINK_CACHE_SIZE 4
+
 struct dp_mst_ch_slot_info {
 	u32 start_slot;
 	u32 tot_slots;
@@ -54,6 +57,32 @@ struct dp_mst_channel_info {
 	struct dp_mst_ch_slot_info slot_info[DP_STREAM_MAX];
 };
 
+struct dp_ctrl_link_cache_key {
+	u32 edid_crc;
+	u8 oui[3];
+	u8 dpcd[DP_RECEIVER_CAP_SIZE];
+};
+
+/**
+ * struct dp_ctrl_link_cache_entry - last known-good link settings of a sink
+ * @key: sink identity, OUI, receiver capabilities and EDID checksum
+ * @bw_code: link rate the sink trained at
+ * @lane_count: lane count the sink trained at
+ * @v_level: voltage swing level the sink settled on
+ * @p_level: pre-emphasis level the sink settled on
+ * @full_ms: duration of the full training which produced this entry
+ * @valid: entry holds trained settings
+ */
+struct dp_ctrl_link_cache_entry {
+	struct dp_ctrl_link_cache_key key;
+	u8 bw_code;
+	u8 lane_count;
+	u8 v_level;
+	u8 p_level;
+	u32 full_ms;
+	bool valid;
+};
+
 struct dp_ctrl_private {
 	struct dp_ctrl dp_ctrl;
 
@@ -85,6 +114,12 @@ struct dp_ctrl_private {
 	u32 stream_count;
 	u32 training_2_pattern;
 	struct dp_mst_channel_info mst_ch_info;
+
+	bool fast_train;
+	bool link_key_valid;
+	struct dp_ctrl_link_cache_key link_key;
+	struct dp_ctrl_link_cache_entry link_cache[DP_CTRL_LINK_CACHE_SIZE];
+	u32 link_cache_next;
 };
 
 enum notification_status {
@@ -390,6 +425,10 @@ static int dp_ctrl_link_training_1(struct dp_ctrl_private *ctrl)
 		else
 			break;
 
+		/* cached settings either work as is or are discarded */
+		if (ctrl->fast_train)
+			break;
+
 		if (ctrl->link->phy_params.v_level == ctrl->link->phy_params.max_v_level) {
 			DP_ERR_RATELIMITED_V("max v_level reached\n");
 			break;
@@ -411,7 +450,7 @@ static int dp_ctrl_link_training_1(struct dp_ctrl_private *ctrl)
 		ctrl->link->adjust_levels(ctrl->link, link_status);
 	}
 
-	if (ret && dp_ctrl_is_link_rate_rbr(ctrl)) {
+	if (ret && !ctrl->fast_train && dp_ctrl_is_link_rate_rbr(ctrl)) {
 		u8 active_lanes = dp_ctrl_get_active_lanes(ctrl, link_status);
 
 		if (active_lanes) {
@@ -536,6 +575,9 @@ static int dp_ctrl_link_training_2(struct dp_ctrl_private *ctrl)
 		else
 			break;
 
+		if (ctrl->fast_train)
+			break;
+
 		if (tries >= maximum_retries) {
 			ret = dp_ctrl_lane_count_down_shift(ctrl);
 			break;
@@ -561,8 +603,11 @@ static int dp_ctrl_link_train(struct dp_ctrl_private *ctrl)
 	u8 const encoding = 0x1, downspread = 0x00;
 	struct drm_dp_link link_info = {0};
 
-	ctrl->link->phy_params.p_level = 0;
-	ctrl->link->phy_params.v_level = 0;
+	/* fast training starts from the cached drive settings */
+	if (!ctrl->fast_train) {
+		ctrl->link->phy_params.p_level = 0;
+		ctrl->link->phy_params.v_level = 0;
+	}
 
 	link_info.num_lanes = ctrl->link->link_params.lane_count;
 	link_info.rate = drm_dp_bw_code_to_link_rate(
@@ -617,6 +662,145 @@ end:
 	return ret;
 }
 
+static void dp_ctrl_link_cache_key(struct dp_ctrl_private *ctrl)
+{
+	struct dp_ctrl_link_cache_key *key = &ctrl->link_key;
+	int rlen;
+
+	memset(key, 0, sizeof(*key));
+	ctrl->link_key_valid = false;
+
+	if (!ctrl->dp_ctrl.fast_train_en || ctrl->sim_mode)
+		return;
+
+	rlen = drm_dp_dpcd_read(ctrl->aux->drm_aux, DP_SINK_OUI, key->oui,
+			sizeof(key->oui));
+	if (rlen != sizeof(key->oui))
+		return;
+
+	memcpy(key->dpcd, ctrl->panel->dpcd, sizeof(key->dpcd));
+
+	/* the extension blocks may still be in flight, key on the base */
+	if (!ctrl->panel->wait_edid(ctrl->panel, true))
+		key->edid_crc = crc32_le(~0, ctrl->panel->edid_base,
+				EDID_LENGTH);
+
+	ctrl->link_key_valid = true;
+}
+
+static struct dp_ctrl_link_cache_entry *dp_ctrl_link_cache_find(
+		struct dp_ctrl_private *ctrl)
+{
+	int i;
+
+	if (!ctrl->link_key_valid || !ctrl->dp_ctrl.fast_train_en)
+		return NULL;
+
+	/* compliance tests expect the full training procedure */
+	if (ctrl->link->sink_request & (DP_TEST_LINK_TRAINING |
+			DP_TEST_LINK_PHY_TEST_PATTERN))
+		return NULL;
+
+	for (i = 0; i < DP_CTRL_LINK_CACHE_SIZE; i++) {
+		struct dp_ctrl_link_cache_entry *entry = &ctrl->link_cache[i];
+
+		if (entry->valid && !memcmp(&entry->key, &ctrl->link_key,
+				sizeof(entry->key)))
+			return entry;
+	}
+
+	return NULL;
+}
+
+static void dp_ctrl_link_cache_store(struct dp_ctrl_private *ctrl,
+		u32 full_ms)
+{
+	struct dp_ctrl_link_cache_entry *entry;
+	struct dp_link_params *link_params = &ctrl->link->link_params;
+
+	if (!ctrl->link_key_valid || ctrl->sim_mode ||
+			(ctrl->link->sink_request & (DP_TEST_LINK_TRAINING |
+			DP_TEST_LINK_PHY_TEST_PATTERN)))
+		return;
+
+	/* a downshifted result would pin the sink below its max rate */
+	if (link_params->bw_code != ctrl->initial_bw_code ||
+			link_params->lane_count != ctrl->initial_lane_count)
+		return;
+
+	entry = dp_ctrl_link_cache_find(ctrl);
+	if (!entry) {
+		entry = &ctrl->link_cache[ctrl->link_cache_next];
+		ctrl->link_cache_next = (ctrl->link_cache_next + 1) %
+				DP_CTRL_LINK_CACHE_SIZE;
+	}
+
+	entry->key = ctrl->link_key;
+	entry->bw_code = link_params->bw_code;
+	entry->lane_count = link_params->lane_count;
+	entry->v_level = ctrl->link->phy_params.v_level;
+	entry->p_level = ctrl->link->phy_params.p_level;
+	entry->full_ms = full_ms;
+	entry->valid = true;
+}
+
+/*
+ * Arm fast training with the cached settings of the connected sink. A
+ * fresh link may start at the cached rate and lane count as long as they
+ * do not exceed the initial ones, an already configured link (retrain)
+ * only reuses the drive settings for the same rate and lane count.
+ */
+static struct dp_ctrl_link_cache_entry *dp_ctrl_link_cache_arm(
+		struct dp_ctrl_private *ctrl, bool keep_rate)
+{
+	struct dp_ctrl_link_cache_entry *entry;
+	struct dp_link_params *link_params = &ctrl->link->link_params;
+
+	entry = dp_ctrl_link_cache_find(ctrl);
+	if (!entry)
+		return NULL;
+
+	if (keep_rate) {
+		if (entry->bw_code != link_params->bw_code ||
+				entry->lane_count != link_params->lane_count)
+			return NULL;
+	} else {
+		if (drm_dp_bw_code_to_link_rate(entry->bw_code) >
+				drm_dp_bw_code_to_link_rate(link_params->bw_code) ||
+				entry->lane_count > link_params->lane_count)
+			return NULL;
+
+		link_params->bw_code = entry->bw_code;
+		link_params->lane_count = entry->lane_count;
+	}
+
+	ctrl->link->phy_params.v_level = entry->v_level;
+	ctrl->link->phy_params.p_level = entry->p_level;
+	ctrl->fast_train = true;
+
+	DP_DEBUG("fast training: bw_code=%d, lane_count=%d, v=%d, p=%d\n",
+			entry->bw_code, entry->lane_count,
+			entry->v_level, entry->p_level);
+
+	return entry;
+}
+
+static void dp_ctrl_link_cache_result(struct dp_ctrl_private *ctrl,
+		struct dp_ctrl_link_cache_entry *entry, bool success, u32 ms)
+{
+	ctrl->fast_train = false;
+
+	if (!success) {
+		entry->valid = false;
+		ctrl->dp_ctrl.fast_train_misses++;
+		return;
+	}
+
+	ctrl->dp_ctrl.fast_train_hits++;
+	if (entry->full_ms > ms)
+		ctrl->dp_ctrl.fast_train_saved_ms += entry->full_ms - ms;
+}
+
 static int dp_ctrl_setup_main_link(struct dp_ctrl_private *ctrl)
 {
 	int ret = 0;
@@ -746,10 +930,14 @@ static int dp_ctrl_link_setup(struct dp_ctrl_private *ctrl, bool shallow)
 	u32 link_train_max_retries = 100;
 	struct dp_catalog_ctrl *catalog;
 	struct dp_link_params *link_params;
+	struct dp_ctrl_link_cache_entry *entry;
+	ktime_t start = ktime_get();
 
 	catalog = ctrl->catalog;
 	link_params = &ctrl->link->link_params;
 
+	entry = dp_ctrl_link_cache_arm(ctrl, false);
+
 	catalog->phy_lane_cfg(catalog, ctrl->orientation,
 				link_params->lane_count);
 
@@ -778,8 +966,35 @@ static int dp_ctrl_link_setup(struct dp_ctrl_private *ctrl, bool shallow)
 		dp_ctrl_select_training_pattern(ctrl, downgrade);
 
 		rc = dp_ctrl_setup_main_link(ctrl);
-		if (!rc)
+		if (!rc) {
+			u32 ms = ktime_ms_delta(ktime_get(), start);
+
+			if (entry)
+				dp_ctrl_link_cache_result(ctrl, entry, true, ms);
+			else
+				dp_ctrl_link_cache_store(ctrl, ms);
 			break;
+		}
+
+		/* cached settings failed, redo the full procedure from scratch */
+		if (entry) {
+			dp_ctrl_link_cache_result(ctrl, entry, false, 0);
+			entry = NULL;
+			link_params->lane_count = ctrl->initial_lane_count;
+			link_params->bw_code = ctrl->initial_bw_code;
+			dp_ctrl_configure_source_link_params(ctrl, false);
+			dp_ctrl_disable_link_clock(ctrl);
+
+			if (!link_train_max_retries ||
+					atomic_read(&ctrl->aborted))
+				break;
+
+			catalog->phy_lane_cfg(catalog, ctrl->orientation,
+					link_params->lane_count);
+			msleep(20);
+			start = ktime_get();
+			continue;
+		}
 
 		/*
 		 * Shallow means link training failure is not important.
@@ -810,6 +1025,8 @@ static int dp_ctrl_link_setup(struct dp_ctrl_private *ctrl, bool shallow)
 		msleep(20);
 	}
 
+	ctrl->fast_train = false;
+
 	return rc;
 }
 
@@ -982,6 +1199,31 @@ static int dp_ctrl_mst_send_act(struct dp_ctrl_private *ctrl)
 	return 0;
 }
 
+static int dp_ctrl_link_retrain(struct dp_ctrl_private *ctrl)
+{
+	struct dp_ctrl_link_cache_entry *entry;
+	ktime_t start = ktime_get();
+	int ret;
+
+	entry = dp_ctrl_link_cache_arm(ctrl, true);
+	if (entry) {
+		ret = dp_ctrl_setup_main_link(ctrl);
+		dp_ctrl_link_cache_result(ctrl, entry, !ret,
+				ktime_ms_delta(ktime_get(), start));
+		if (!ret)
+			return 0;
+
+		start = ktime_get();
+	}
+
+	ret = dp_ctrl_setup_main_link(ctrl);
+	if (!ret)
+		dp_ctrl_link_cache_store(ctrl,
+				ktime_ms_delta(ktime_get(), start));
+
+	return ret;
+}
+
 static int dp_ctrl_link_maintenance(struct dp_ctrl *dp_ctrl)
 {
 	int ret = 0;
@@ -1007,7 +1249,7 @@ static int dp_ctrl_link_maintenance(struct dp_ctrl *dp_ctrl)
 		goto end;
 
 	ctrl->aux->state |= DP_STATE_LINK_MAINTENANCE_STARTED;
-	ret = dp_ctrl_setup_main_link(ctrl);
+	ret = dp_ctrl_link_retrain(ctrl);
 	ctrl->aux->state &= ~DP_STATE_LINK_MAINTENANCE_STARTED;
 
 	if (ret) {
@@ -1266,11 +1508,6 @@ static void dp_ctrl_dsc_setup(struct dp_ctrl_private *ctrl, struct dp_panel *pan
 		DP_WARN("failed to enable sink dsc\n");
 }
 
-static int dp_ctrl_link_retrain(struct dp_ctrl_private *ctrl)
-{
-	return dp_ctrl_setup_main_link(ctrl);
-}
-
 static bool dp_ctrl_channel_eq_ok(struct dp_ctrl_private *ctrl)
 {
 	u8 link_status[DP_LINK_STATUS_SIZE];
@@ -1449,6 +1686,8 @@ static int dp_ctrl_on(struct dp_ctrl *dp_ctrl, bool mst_mode,
 	ctrl->initial_lane_count = ctrl->link->link_params.lane_count;
 	ctrl->initial_bw_code = ctrl->link->link_params.bw_code;
 
+	dp_ctrl_link_cache_key(ctrl);
+
 	rc = dp_ctrl_link_setup(ctrl, shallow);
 	if (!rc)
 		ctrl->power_on = true;
@@ -1481,6 +1720,7 @@ static void dp_ctrl_off(struct dp_ctrl *dp_ctrl)
 	ctrl->fec_mode = false;
 	ctrl->dsc_mode = false;
 	ctrl->power_on = false;
+	ctrl->link_key_valid = false;
 	memset(&ctrl->mst_ch_info, 0, sizeof(ctrl->mst_ch_info));
 	DP_DEBUG("DP off done\n");
 }
@@ -1599,6 +1839,7 @@ struct dp_ctrl *dp_ctrl_get(struct dp_ctrl_in *in)
 	ctrl->fec_mode = false;
 
 	dp_ctrl = &ctrl->dp_ctrl;
+	dp_ctrl->fast_train_en = true;
 
 	/* out parameters */
 	dp_ctrl->init      = dp_ctrl_host_init;
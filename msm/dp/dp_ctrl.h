@@ -16,6 +16,12 @@
 #include "dp_debug.h"
 
 struct dp_ctrl {
+	/* link training with the last known-good settings of the sink */
+	bool fast_train_en;
+	u32 fast_train_hits;
+	u32 fast_train_misses;
+	u64 fast_train_saved_ms;
+
 	int (*init)(struct dp_ctrl *dp_ctrl, bool flip, bool reset);
 	void (*deinit)(struct dp_ctrl *dp_ctrl);
 	int (*on)(struct dp_ctrl *dp_ctrl, bool mst_mode, bool fec_en,
@@ -1861,6 +1861,140 @@ end:
 	return len;
 }
 
+static ssize_t dp_debug_read_aux_stats(struct file *file,
+		char __user *user_buff, size_t count, loff_t *ppos)
+{
+	static const char * const xfer_name[DP_AUX_XFER_MAX] = {
+		[DP_AUX_XFER_NATIVE_READ] = "native_rd",
+		[DP_AUX_XFER_NATIVE_WRITE] = "native_wr",
+		[DP_AUX_XFER_I2C_READ] = "i2c_rd",
+		[DP_AUX_XFER_I2C_WRITE] = "i2c_wr",
+	};
+	struct dp_debug_private *debug = file->private_data;
+	struct dp_aux_stats *stats;
+	char *buf;
+	int len = 0, rc = 0, max_size = SZ_4K;
+	int i, j;
+
+	if (!debug)
+		return -ENODEV;
+
+	if (*ppos)
+		return 0;
+
+	buf = kzalloc(SZ_4K, GFP_KERNEL);
+	if (ZERO_OR_NULL_PTR(buf))
+		return -ENOMEM;
+
+	stats = &debug->aux->stats;
+
+	rc = scnprintf(buf + len, max_size, "%-10s %8s %10s %8s", "type",
+			"count", "avg_us", "max_us");
+	if (dp_debug_check_buffer_overflow(rc, &max_size, &len))
+		goto end;
+
+	for (j = 0; j < DP_AUX_LAT_BUCKETS - 1; j++) {
+		rc = scnprintf(buf + len, max_size, " <%-6u",
+				DP_AUX_LAT_BUCKET_US(j));
+		if (dp_debug_check_buffer_overflow(rc, &max_size, &len))
+			goto end;
+	}
+
+	rc = scnprintf(buf + len, max_size, " >=%-5u\n",
+			DP_AUX_LAT_BUCKET_US(DP_AUX_LAT_BUCKETS - 2));
+	if (dp_debug_check_buffer_overflow(rc, &max_size, &len))
+		goto end;
+
+	for (i = 0; i < DP_AUX_XFER_MAX; i++) {
+		rc = scnprintf(buf + len, max_size, "%-10s %8u %10llu %8u",
+				xfer_name[i], stats->count[i],
+				stats->count[i] ? div_u64(stats->total_us[i],
+				stats->count[i]) : 0, stats->max_us[i]);
+		if (dp_debug_check_buffer_overflow(rc, &max_size, &len))
+			goto end;
+
+		for (j = 0; j < DP_AUX_LAT_BUCKETS; j++) {
+			rc = scnprintf(buf + len, max_size, " %-7u",
+					stats->lat_hist[i][j]);
+			if (dp_debug_check_buffer_overflow(rc, &max_size, &len))
+				goto end;
+		}
+
+		rc = scnprintf(buf + len, max_size, "\n");
+		if (dp_debug_check_buffer_overflow(rc, &max_size, &len))
+			goto end;
+	}
+
+	rc = scnprintf(buf + len, max_size,
+			"defer=%u nack=%u timeout=%u addr_err=%u phy_err=%u cfg1_rotations=%u\n",
+			stats->defer, stats->nack, stats->timeout,
+			stats->addr_err, stats->phy_err, stats->cfg1_rotations);
+	if (dp_debug_check_buffer_overflow(rc, &max_size, &len))
+		goto end;
+end:
+	len = min_t(size_t, count, len);
+	if (copy_to_user(user_buff, buf, len)) {
+		kfree(buf);
+		return -EFAULT;
+	}
+
+	*ppos += len;
+	kfree(buf);
+
+	return len;
+}
+
+static ssize_t dp_debug_read_connect_timing(struct file *file,
+		char __user *user_buff, size_t count, loff_t *ppos)
+{
+	static const char * const stage_name[DP_CONNECT_STAGE_MAX] = {
+		[DP_CONNECT_STAGE_HOST_READY] = "host_ready",
+		[DP_CONNECT_STAGE_PANEL_READY] = "panel_ready",
+		[DP_CONNECT_STAGE_SINK_CAPS] = "sink_caps",
+		[DP_CONNECT_STAGE_EDID_BASE] = "edid_base",
+		[DP_CONNECT_STAGE_EDID] = "edid",
+		[DP_CONNECT_STAGE_LINK_TRAINED] = "link_trained",
+		[DP_CONNECT_STAGE_HDCP_CAPS] = "hdcp_caps",
+		[DP_CONNECT_STAGE_NOTIFIED] = "notified",
+		[DP_CONNECT_STAGE_ENABLED] = "enabled",
+	};
+	struct dp_debug_private *debug = file->private_data;
+	char buf[SZ_512];
+	int len = 0, i;
+
+	if (!debug)
+		return -ENODEV;
+
+	if (*ppos)
+		return 0;
+
+	for (i = 0; i < DP_CONNECT_STAGE_MAX; i++)
+		len += scnprintf(buf + len, sizeof(buf) - len, "%s=%uus\n",
+				stage_name[i],
+				debug->dp_debug.connect_stage_us[i]);
+
+	len = min_t(size_t, count, len);
+	if (copy_to_user(user_buff, buf, len))
+		return -EFAULT;
+
+	*ppos += len;
+	return len;
+}
+
+/* any write clears the aux statistics */
+static ssize_t dp_debug_write_aux_stats(struct file *file,
+		const char __user *user_buff, size_t count, loff_t *ppos)
+{
+	struct dp_debug_private *debug = file->private_data;
+
+	if (!debug)
+		return -ENODEV;
+
+	memset(&debug->aux->stats, 0, sizeof(debug->aux->stats));
+
+	return count;
+}
+
 static ssize_t dp_debug_write_dump(struct file *file,
 		const char __user *user_buff, size_t count, loff_t *ppos)
 {
@@ -2033,6 +2167,17 @@ static const struct file_operations dump_fops = {
 	.read = dp_debug_read_dump,
 };
 
+static const struct file_operations connect_timing_fops = {
+	.open = simple_open,
+	.read = dp_debug_read_connect_timing,
+};
+
+static const struct file_operations aux_stats_fops = {
+	.open = simple_open,
+	.write = dp_debug_write_aux_stats,
+	.read = dp_debug_read_aux_stats,
+};
+
 static const struct file_operations mst_mode_fops = {
 	.open = simple_open,
 	.write = dp_debug_mst_mode_write,
@@ -2279,6 +2424,45 @@ static int dp_debug_init_status(struct dp_debug_private *debug,
 		return rc;
 	}
 
+	debugfs_create_u32("mode_cache_hits", 0444, dir,
+			&debug->dp_debug.mode_cache_hits);
+	debugfs_create_u32("mode_cache_misses", 0444, dir,
+			&debug->dp_debug.mode_cache_misses);
+	debugfs_create_u64("mode_validate_us", 0444, dir,
+			&debug->dp_debug.mode_validate_us);
+	file = debugfs_create_file("connect_timing", 0444, dir, debug,
+			&connect_timing_fops);
+	if (IS_ERR_OR_NULL(file)) {
+		rc = PTR_ERR(file);
+		DP_ERR("[%s] debugfs connect_timing failed, rc=%d\n",
+			debug->name, rc);
+		return rc;
+	}
+
+	file = debugfs_create_file("aux_stats", 0644, dir, debug,
+			&aux_stats_fops);
+	if (IS_ERR_OR_NULL(file)) {
+		rc = PTR_ERR(file);
+		DP_ERR("[%s] debugfs aux_stats failed, rc=%d\n",
+			debug->name, rc);
+		return rc;
+	}
+
+	debugfs_create_bool("dpcd_cache_en", 0644, dir,
+			&debug->aux->dpcd_cache_en);
+	debugfs_create_u32("dpcd_cache_hits", 0444, dir,
+			&debug->aux->dpcd_cache_hits);
+	debugfs_create_u32("dpcd_cache_misses", 0444, dir,
+			&debug->aux->dpcd_cache_misses);
+	debugfs_create_bool("fast_train_en", 0644, dir,
+			&debug->ctrl->fast_train_en);
+	debugfs_create_u32("fast_train_hits", 0444, dir,
+			&debug->ctrl->fast_train_hits);
+	debugfs_create_u32("fast_train_misses", 0444, dir,
+			&debug->ctrl->fast_train_misses);
+	debugfs_create_u64("fast_train_saved_ms", 0444, dir,
+			&debug->ctrl->fast_train_saved_ms);
+
 	return rc;
 }
 
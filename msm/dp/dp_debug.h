@@ -90,6 +90,23 @@
 #define DEFAULT_CONNECT_NOTIFICATION_DELAY_MS 150
 #define MAX_CONNECT_NOTIFICATION_DELAY_MS 5000
 
+/*
+ * Milestones of the HPD high connect flow, recorded in
+ * dp_debug::connect_stage_us relative to the start of HPD high processing.
+ */
+enum dp_connect_stage {
+	DP_CONNECT_STAGE_HOST_READY,
+	DP_CONNECT_STAGE_PANEL_READY,
+	DP_CONNECT_STAGE_SINK_CAPS,
+	DP_CONNECT_STAGE_EDID_BASE,
+	DP_CONNECT_STAGE_EDID,
+	DP_CONNECT_STAGE_LINK_TRAINED,
+	DP_CONNECT_STAGE_HDCP_CAPS,
+	DP_CONNECT_STAGE_NOTIFIED,
+	DP_CONNECT_STAGE_ENABLED,
+	DP_CONNECT_STAGE_MAX,
+};
+
 /**
  * struct dp_debug
  * @sim_mode: specifies whether sim mode enabled
@@ -108,6 +125,11 @@
  *              messages before sending the connect notification uevent
  * @disconnect_delay_ms: time (in ms) to wait before turning off the mainlink
  *              in response to HPD low of cable disconnect event
+ * @mode_cache_hits: mode validations answered from the validation cache
+ * @mode_cache_misses: mode validations which ran the full checks
+ * @mode_validate_us: total time (in us) spent validating modes
+ * @connect_stage_us: time (in us) from the start of HPD high processing to
+ *              each dp_connect_stage of the last connect
  */
 struct dp_debug {
 	bool sim_mode;
@@ -124,6 +146,10 @@ struct dp_debug {
 	int mst_sim_remove_con_id;
 	unsigned long connect_notification_delay_ms;
 	u32 disconnect_delay_ms;
+	u32 mode_cache_hits;
+	u32 mode_cache_misses;
+	u64 mode_validate_us;
+	u32 connect_stage_us[DP_CONNECT_STAGE_MAX];
 
 	void (*abort)(struct dp_debug *dp_debug);
 	void (*set_mst_con)(struct dp_debug *dp_debug, int con_id);
@@ -14,6 +14,7 @@
 #include <linux/usb/phy.h>
 #include <linux/jiffies.h>
 #include <linux/pm_qos.h>
+#include <linux/jhash.h>
 #include <linux/soc/qcom/pmic_glink_altmode.h>
 #if __has_include(<linux/ipc_logging.h>)
 #include <linux/ipc_logging.h>
@@ -40,6 +41,7 @@
 #include "sde_dbg.h"
 
 #define DRM_DP_IPC_NUM_PAGES 10
+#define DP_MODE_CACHE_SIZE 256
 #define DP_MST_DEBUG(fmt, ...) DP_DEBUG(fmt, ##__VA_ARGS__)
 
 #define dp_display_state_show(x) { \
@@ -211,6 +213,7 @@ struct dp_display_private {
 	struct delayed_work hdcp_cb_work;
 	struct work_struct connect_work;
 	struct work_struct attention_work;
+	struct work_struct hdcp_caps_work;
 	struct mutex session_lock;
 	struct mutex accounting_lock;
 	bool hdcp_delayed_off;
@@ -232,6 +235,8 @@ struct dp_display_private {
 	u32 intf_idx[DP_STREAM_MAX];
 	u32 phy_idx;
 	u32 stream_cnt;
+
+	ktime_t connect_start;
 };
 
 static const struct dp_display_type_info dp_info = {
@@ -255,6 +260,25 @@ static inline bool dp_display_is_hdcp_enabled(struct dp_display_private *dp)
 	return dp->link->hdcp_status.hdcp_version && dp->hdcp.ops;
 }
 
+static void dp_display_connect_stage_at(struct dp_display_private *dp,
+		enum dp_connect_stage stage, ktime_t ts)
+{
+	u32 us;
+
+	if (ktime_before(ts, dp->connect_start))
+		return;
+
+	us = ktime_us_delta(ts, dp->connect_start);
+	dp->debug->connect_stage_us[stage] = us;
+	SDE_EVT32_EXTERNAL(stage, us);
+}
+
+static void dp_display_connect_stage(struct dp_display_private *dp,
+		enum dp_connect_stage stage)
+{
+	dp_display_connect_stage_at(dp, stage, ktime_get());
+}
+
 static irqreturn_t dp_display_irq(int irq, void *dev_id)
 {
 	struct dp_display_private *dp = dev_id;
@@ -519,11 +543,28 @@ static int dp_display_hdcp_process_sink_sync(struct dp_display_private *dp)
 	return 0;
 }
 
+/*
+ * Querying the HDCP source capabilities can take a trip through the secure
+ * world. Start it as soon as the MST state is known so it overlaps with
+ * link training and the connect notification instead of delaying HDCP
+ * authentication after enable.
+ */
+static void dp_display_hdcp_caps_work(struct work_struct *work)
+{
+	struct dp_display_private *dp = container_of(work,
+			struct dp_display_private, hdcp_caps_work);
+
+	dp_display_check_source_hdcp_caps(dp);
+	dp_display_connect_stage(dp, DP_CONNECT_STAGE_HDCP_CAPS);
+}
+
 static int dp_display_hdcp_start(struct dp_display_private *dp)
 {
 	if (dp->link->hdcp_status.hdcp_state != HDCP_STATE_INACTIVE)
 		return -EINVAL;
 
+	/* source_cap is sticky, this only re-applies the current mode */
+	flush_work(&dp->hdcp_caps_work);
 	dp_display_check_source_hdcp_caps(dp);
 	dp_display_update_hdcp_info(dp);
 
@@ -784,6 +825,7 @@ static int dp_display_pre_hw_release(void *data)
 	dp_display_state_add(DP_STATE_TUI_ACTIVE);
 	cancel_work_sync(&dp->connect_work);
 	cancel_work_sync(&dp->attention_work);
+	cancel_work_sync(&dp->hdcp_caps_work);
 	flush_workqueue(dp->wq);
 
 	dp_display_pause_audio(dp, true);
@@ -1014,6 +1056,7 @@ static int dp_display_send_hpd_notification(struct dp_display_private *dp, bool
 	if (hpd) {
 		dp_display_state_add(DP_STATE_CONNECT_NOTIFIED);
 		dp_display_state_remove(DP_STATE_DISCONNECT_NOTIFIED);
+		dp_display_connect_stage(dp, DP_CONNECT_STAGE_NOTIFIED);
 	} else {
 		dp_display_state_add(DP_STATE_DISCONNECT_NOTIFIED);
 		dp_display_state_remove(DP_STATE_CONNECT_NOTIFIED);
@@ -1304,6 +1347,11 @@ static int dp_display_process_hpd_high(struct dp_display_private *dp)
 	}
 
 	dp_display_state_add(DP_STATE_CONNECTED);
+	dp->aux->dpcd_cache_invalidate(dp->aux);
+
+	dp->connect_start = ktime_get();
+	memset(dp->debug->connect_stage_us, 0,
+			sizeof(dp->debug->connect_stage_us));
 
 	dp->dp_display.max_pclk_khz = min(dp->parser->max_pclk_khz,
 					dp->debug->max_pclk_khz);
@@ -1356,8 +1404,10 @@ static int dp_display_process_hpd_high(struct dp_display_private *dp)
 		dp_display_state_show("[ready failed]");
 		goto err_state;
 	}
+	dp_display_connect_stage(dp, DP_CONNECT_STAGE_HOST_READY);
 
 	rc = dp_display_panel_ready(dp);
+	dp_display_connect_stage(dp, DP_CONNECT_STAGE_PANEL_READY);
 
 	dp->link->psm_config(dp->link, &dp->panel->link_info, false);
 	dp->debug->psm_enabled = false;
@@ -1373,14 +1423,27 @@ static int dp_display_process_hpd_high(struct dp_display_private *dp)
 	 */
 	if (rc == -ETIMEDOUT || rc == -ENOTCONN)
 		goto err_unready;
+	dp_display_connect_stage(dp, DP_CONNECT_STAGE_SINK_CAPS);
 
 	dp->link->process_request(dp->link);
 	dp->panel->handle_sink_request(dp->panel);
 
 	dp_display_mst_init(dp);
 
+	queue_work(system_unbound_wq, &dp->hdcp_caps_work);
+
 	rc = dp->ctrl->on(dp->ctrl, dp->mst.mst_active,
 			dp->panel->fec_en, dp->panel->dsc_en, false);
+	if (!rc)
+		dp_display_connect_stage(dp, DP_CONNECT_STAGE_LINK_TRAINED);
+
+	/* EDID extension blocks are streamed during link training */
+	dp->panel->wait_edid(dp->panel, false);
+	dp_display_connect_stage_at(dp, DP_CONNECT_STAGE_EDID_BASE,
+			dp->panel->edid_base_ts);
+	dp_display_connect_stage_at(dp, DP_CONNECT_STAGE_EDID,
+			dp->panel->edid_ts);
+
 	if (rc)
 		goto err_mst;
 
@@ -1768,6 +1831,7 @@ static void dp_display_disconnect_sync(struct dp_display_private *dp)
 	/* wait for idle state */
 	cancel_work_sync(&dp->connect_work);
 	cancel_work_sync(&dp->attention_work);
+	cancel_work_sync(&dp->hdcp_caps_work);
 	flush_workqueue(dp->wq);
 
 	/*
@@ -2008,6 +2072,9 @@ static int dp_display_usbpd_attention_cb(struct device *dev)
 			!!dp_display_state_is(DP_STATE_ENABLED),
 			!!dp_display_state_is(DP_STATE_CONNECTED));
 
+	/* sink capabilities may change across any HPD or IRQ_HPD */
+	dp->aux->dpcd_cache_invalidate(dp->aux);
+
 	if (!dp->hpd->hpd_high) {
 		dp_display_disconnect_sync(dp);
 		return 0;
@@ -2737,6 +2804,9 @@ static int dp_display_post_enable(struct dp_display *dp_display, void *panel)
 
 	dp_display_stream_post_enable(dp, dp_panel);
 
+	if (!dp->debug->connect_stage_us[DP_CONNECT_STAGE_ENABLED])
+		dp_display_connect_stage(dp, DP_CONNECT_STAGE_ENABLED);
+
 	if ((dp_display->is_edp) && (!dp_display->no_backlight_support)) {
 		rc = dp->power->edp_panel_set_gpio(dp->power, DP_GPIO_EDP_BACKLIGHT_EN, true);
 		if (rc) {
@@ -3169,6 +3239,164 @@ end:
 	return rc;
 }
 
+/*
+ * Account the DSC blocks a mode needs against the blocks left free by the
+ * other panels, and flag DSC support in the mode capabilities if they fit.
+ */
+static int dp_display_reserve_dsc(struct dp_display_private *dp,
+		struct dp_panel *dp_panel,
+		const struct drm_display_mode *drm_mode,
+		struct dp_display_mode *dp_mode)
+{
+	struct dp_display *dp_display = &dp->dp_display;
+	u32 free_dsc_blks = 0, required_dsc_blks = 0, curr_dsc = 0, new_dsc = 0;
+	int rc;
+
+	if (!dp_panel->dsc_en)
+		return 0;
+
+	free_dsc_blks = dp_display->max_dsc_count -
+			dp->tot_dsc_blks_in_use +
+			dp_panel->dsc_blks_in_use;
+	DP_DEBUG_V("Before: in_use:%d, max:%d, free:%d\n",
+			dp->tot_dsc_blks_in_use,
+			dp_display->max_dsc_count, free_dsc_blks);
+
+	rc = msm_get_dsc_count(dp->priv, drm_mode->hdisplay,
+			&required_dsc_blks);
+	if (rc) {
+		DP_ERR("error getting dsc count. rc:%d\n", rc);
+		return rc;
+	}
+
+	curr_dsc = dp_panel->dsc_blks_in_use;
+	dp->tot_dsc_blks_in_use -= dp_panel->dsc_blks_in_use;
+	dp_panel->dsc_blks_in_use = 0;
+
+	if (free_dsc_blks >= required_dsc_blks) {
+		dp_mode->capabilities |= DP_PANEL_CAPS_DSC;
+		new_dsc = max(curr_dsc, required_dsc_blks);
+		dp_panel->dsc_blks_in_use = new_dsc;
+		dp->tot_dsc_blks_in_use += new_dsc;
+	}
+
+	DP_DEBUG_V("After: in_use:%d, max:%d, free:%d, req:%d, caps:0x%x\n",
+			dp->tot_dsc_blks_in_use,
+			dp_display->max_dsc_count,
+			free_dsc_blks, required_dsc_blks,
+			dp_mode->capabilities);
+
+	return 0;
+}
+
+/*
+ * Everything mode validation depends on besides the mode itself: the sink
+ * EDID, the link configuration, the panel feature state and the display
+ * resources left for this panel.
+ */
+struct dp_mode_cache_key {
+	int clock;
+	u16 hdisplay, hsync_start, hsync_end, htotal, hskew;
+	u16 vdisplay, vsync_start, vsync_end, vtotal, vscan;
+	u32 flags;
+	u32 capabilities;
+
+	u32 edid_crc;
+	u32 bw_code;
+	u32 lane_count;
+	u32 max_pclk_khz;
+	u32 max_supported_bpp;
+	bool mst_active;
+	bool dsc_en;
+	bool fec_en;
+	bool widebus_en;
+	int avail_lm;
+	struct msm_resource_caps_info avail_res;
+};
+
+struct dp_mode_cache_entry {
+	struct dp_mode_cache_key key;
+	enum drm_mode_status status;
+	u32 lm_count;
+	bool valid;
+};
+
+struct dp_mode_cache {
+	struct dp_mode_cache_entry entries[DP_MODE_CACHE_SIZE];
+};
+
+static void dp_display_mode_cache_key(struct dp_display_private *dp,
+		struct dp_panel *dp_panel, const struct drm_display_mode *mode,
+		const struct dp_display_mode *dp_mode,
+		const struct msm_resource_caps_info *avail_res,
+		struct dp_mode_cache_key *key)
+{
+	/* zero the padding too, the key is hashed and compared as memory */
+	memset(key, 0, sizeof(*key));
+
+	key->clock = mode->clock;
+	key->hdisplay = mode->hdisplay;
+	key->hsync_start = mode->hsync_start;
+	key->hsync_end = mode->hsync_end;
+	key->htotal = mode->htotal;
+	key->hskew = mode->hskew;
+	key->vdisplay = mode->vdisplay;
+	key->vsync_start = mode->vsync_start;
+	key->vsync_end = mode->vsync_end;
+	key->vtotal = mode->vtotal;
+	key->vscan = mode->vscan;
+	key->flags = mode->flags;
+	key->capabilities = dp_mode->capabilities;
+
+	key->edid_crc = dp_panel->edid_crc;
+
+	if (dp->dp_display.is_edp) {
+		key->bw_code = dp->panel->link_info.rate;
+		key->lane_count = dp->panel->link_info.num_lanes;
+	} else {
+		key->bw_code = dp->link->link_params.bw_code;
+		key->lane_count = dp->link->link_params.lane_count;
+	}
+
+	key->max_pclk_khz = dp->dp_display.max_pclk_khz;
+	key->max_supported_bpp = dp_panel->max_supported_bpp;
+	key->mst_active = dp->mst.mst_active;
+	key->dsc_en = dp_panel->dsc_en;
+	key->fec_en = dp_panel->fec_en;
+	key->widebus_en = dp_panel->widebus_en;
+
+	mutex_lock(&dp->accounting_lock);
+	key->avail_lm = avail_res->num_lm + avail_res->num_lm_in_use -
+			dp->tot_lm_blks_in_use + dp_panel->max_lm;
+	mutex_unlock(&dp->accounting_lock);
+
+	key->avail_res.num_lm_in_use = avail_res->num_lm_in_use;
+	key->avail_res.num_lm = avail_res->num_lm;
+	key->avail_res.num_dsc = avail_res->num_dsc;
+	key->avail_res.num_vdc = avail_res->num_vdc;
+	key->avail_res.num_ctl = avail_res->num_ctl;
+	key->avail_res.num_3dmux = avail_res->num_3dmux;
+	key->avail_res.max_mixer_width = avail_res->max_mixer_width;
+	key->avail_res.merge_3d_mask = avail_res->merge_3d_mask;
+}
+
+static struct dp_mode_cache_entry *dp_display_mode_cache_get(
+		struct dp_panel *dp_panel, struct dp_mode_cache_key *key)
+{
+	u32 idx;
+
+	if (!dp_panel->mode_cache) {
+		dp_panel->mode_cache = kvzalloc(sizeof(*dp_panel->mode_cache),
+				GFP_KERNEL);
+		if (!dp_panel->mode_cache)
+			return NULL;
+	}
+
+	idx = jhash(key, sizeof(*key), 0) % DP_MODE_CACHE_SIZE;
+
+	return &dp_panel->mode_cache->entries[idx];
+}
+
 static enum drm_mode_status dp_display_validate_mode(
 		struct dp_display *dp_display,
 		void *panel, struct drm_display_mode *mode,
@@ -3176,10 +3404,13 @@ static enum drm_mode_status dp_display_validate_mode(
 {
 	struct dp_display_private *dp;
 	struct dp_panel *dp_panel;
-	struct dp_debug *debug;
+	struct dp_debug *debug = NULL;
 	enum drm_mode_status mode_status = MODE_BAD;
 	struct dp_display_mode dp_mode;
-	int rc = 0;
+	struct dp_mode_cache_key key;
+	struct dp_mode_cache_entry *entry;
+	ktime_t start = ktime_get();
+	int rc = 0, dsc_rc;
 
 	if (!dp_display || !mode || !panel ||
 			!avail_res || !avail_res->max_mixer_width) {
@@ -3201,7 +3432,25 @@ static enum drm_mode_status dp_display_validate_mode(
 	if (!debug)
 		goto end;
 
-	dp_display->convert_to_dp_mode(dp_display, panel, mode, &dp_mode);
+	memset(&dp_mode, 0, sizeof(dp_mode));
+	dsc_rc = dp_display_reserve_dsc(dp, dp_panel, mode, &dp_mode);
+
+	dp_display_mode_cache_key(dp, dp_panel, mode, &dp_mode, avail_res, &key);
+
+	/* a failed DSC query leaves the mode unconverted, don't cache that */
+	entry = dsc_rc ? NULL : dp_display_mode_cache_get(dp_panel, &key);
+	if (entry && entry->valid && !memcmp(&entry->key, &key, sizeof(key))) {
+		debug->mode_cache_hits++;
+		mode_status = entry->status;
+		dp_mode.lm_count = entry->lm_count;
+		if (mode_status == MODE_OK)
+			goto update_lm;
+		goto end;
+	}
+
+	debug->mode_cache_misses++;
+	if (!dsc_rc)
+		dp_panel->convert_to_dp_mode(dp_panel, mode, &dp_mode);
 
 	/* As per spec, 640x480 mode should always be present as fail-safe */
 	if ((dp_mode.timing.h_active == 640) && (dp_mode.timing.v_active == 480) &&
@@ -3216,19 +3465,29 @@ static enum drm_mode_status dp_display_validate_mode(
 	}
 
 	if (rc)
-		goto end;
+		goto store;
 
 	rc = dp_display_validate_link_clock(dp, mode, dp_mode);
 	if (rc)
-		goto end;
+		goto store;
 
 	rc = dp_display_validate_pixel_clock(dp_mode, dp_display->max_pclk_khz);
 	if (rc)
-		goto end;
+		goto store;
 
 skip_validation:
 	mode_status = MODE_OK;
+store:
+	if (entry) {
+		entry->key = key;
+		entry->status = mode_status;
+		entry->lm_count = dp_mode.lm_count;
+		entry->valid = true;
+	}
 
+	if (mode_status != MODE_OK)
+		goto end;
+update_lm:
 	if (!avail_res->num_lm_in_use) {
 		mutex_lock(&dp->accounting_lock);
 		dp->tot_lm_blks_in_use -= dp_panel->max_lm;
@@ -3238,6 +3497,8 @@ skip_validation:
 	}
 
 end:
+	if (debug)
+		debug->mode_validate_us += ktime_us_delta(ktime_get(), start);
 	mutex_unlock(&dp->session_lock);
 
 	DP_DEBUG_V("[%s clk:%d] mode is %s\n", mode->name, mode->clock,
@@ -3305,10 +3566,8 @@ static void dp_display_convert_to_dp_mode(struct dp_display *dp_display,
 		const struct drm_display_mode *drm_mode,
 		struct dp_display_mode *dp_mode)
 {
-	int rc;
 	struct dp_display_private *dp;
 	struct dp_panel *dp_panel;
-	u32 free_dsc_blks = 0, required_dsc_blks = 0, curr_dsc = 0, new_dsc = 0;
 
 	if (!dp_display || !drm_mode || !dp_mode || !panel) {
 		DP_ERR("invalid input\n");
@@ -3320,38 +3579,8 @@ static void dp_display_convert_to_dp_mode(struct dp_display *dp_display,
 
 	memset(dp_mode, 0, sizeof(*dp_mode));
 
-	if (dp_panel->dsc_en) {
-		free_dsc_blks = dp_display->max_dsc_count -
-				dp->tot_dsc_blks_in_use +
-				dp_panel->dsc_blks_in_use;
-		DP_DEBUG_V("Before: in_use:%d, max:%d, free:%d\n",
-				dp->tot_dsc_blks_in_use,
-				dp_display->max_dsc_count, free_dsc_blks);
-
-		rc = msm_get_dsc_count(dp->priv, drm_mode->hdisplay,
-				&required_dsc_blks);
-		if (rc) {
-			DP_ERR("error getting dsc count. rc:%d\n", rc);
-			return;
-		}
-
-		curr_dsc = dp_panel->dsc_blks_in_use;
-		dp->tot_dsc_blks_in_use -= dp_panel->dsc_blks_in_use;
-		dp_panel->dsc_blks_in_use = 0;
-
-		if (free_dsc_blks >= required_dsc_blks) {
-			dp_mode->capabilities |= DP_PANEL_CAPS_DSC;
-			new_dsc = max(curr_dsc, required_dsc_blks);
-			dp_panel->dsc_blks_in_use = new_dsc;
-			dp->tot_dsc_blks_in_use += new_dsc;
-		}
-
-		DP_DEBUG_V("After: in_use:%d, max:%d, free:%d, req:%d, caps:0x%x\n",
-				dp->tot_dsc_blks_in_use,
-				dp_display->max_dsc_count,
-				free_dsc_blks, required_dsc_blks,
-				dp_mode->capabilities);
-	}
+	if (dp_display_reserve_dsc(dp, dp_panel, drm_mode, dp_mode))
+		return;
 
 	dp_panel->convert_to_dp_mode(dp_panel, drm_mode, dp_mode);
 }
@@ -3436,6 +3665,7 @@ static int dp_display_create_workqueue(struct dp_display_private *dp)
 	INIT_DELAYED_WORK(&dp->hdcp_cb_work, dp_display_hdcp_cb_work);
 	INIT_WORK(&dp->connect_work, dp_display_connect_work);
 	INIT_WORK(&dp->attention_work, dp_display_attention_work);
+	INIT_WORK(&dp->hdcp_caps_work, dp_display_hdcp_caps_work);
 
 	return 0;
 }
@@ -19,6 +19,7 @@
 #include <linux/debugfs.h>
 #include <linux/version.h>
 #include <linux/platform_device.h>
+#include <linux/workqueue.h>
 #include <drm/drm_edid.h>
 #if (LINUX_VERSION_CODE >= KERNEL_VERSION(5, 19, 0))
 #include <drm/display/drm_dp_helper.h>
@@ -76,6 +77,11 @@ struct dp_sim_device {
 	bool skip_config;
 	bool skip_hpd;
 	bool skip_mst;
+
+	struct delayed_work load_work;
+	u32 load_remain;
+	u32 load_interval_ms;
+	u32 load_port_mask;
 };
 
 struct dp_sim_debug_edid_entry {
@@ -1235,12 +1241,10 @@ static ssize_t dp_sim_debug_write_mst_hpd(struct file *file,
 	if (kstrtoint(buf, 10, &hpd) != 0)
 		goto end;
 
-	mutex_lock(&debug->lock);
 	dp_sim_update_port_status(&debug->bridge,
 				entry->index, hpd ?
 				connector_status_connected :
 				connector_status_disconnected);
-	mutex_unlock(&debug->lock);
 
 end:
 	return len;
@@ -1387,6 +1391,191 @@ static const struct file_operations sim_mst_mode_fops = {
 	.write = dp_sim_debug_write_mst_mode,
 };
 
+static const char * const dp_sim_mst_msg_names[DP_MST_SIM_MSG_MAX] = {
+	[DP_MST_SIM_MSG_LINK_ADDRESS] = "link_address",
+	[DP_MST_SIM_MSG_ENUM_PATH_RESOURCES] = "enum_path_res",
+	[DP_MST_SIM_MSG_ALLOCATE_PAYLOAD] = "alloc_payload",
+	[DP_MST_SIM_MSG_REMOTE_I2C_READ] = "remote_i2c_read",
+	[DP_MST_SIM_MSG_POWER_UPDOWN_PHY] = "power_updown_phy",
+	[DP_MST_SIM_MSG_CLEAR_PAYLOAD_ID_TABLE] = "clear_payload",
+	[DP_MST_SIM_MSG_OTHER] = "other",
+	[DP_MST_SIM_MSG_CONNECTION_NOTIFY] = "conn_notify",
+};
+
+static ssize_t dp_sim_debug_read_mst_stats(struct file *file,
+		char __user *user_buff, size_t count, loff_t *ppos)
+{
+	struct dp_sim_device *debug = file->private_data;
+	struct dp_mst_sim_stats *stats;
+	struct dp_mst_sim_msg_stats *msg;
+	u64 msgs = 0, bytes = 0, elapsed_ms;
+	char *buf;
+	int const buf_size = SZ_4K;
+	u32 len = 0, i;
+
+	if (!debug)
+		return -ENODEV;
+
+	if (*ppos)
+		return 0;
+
+	buf = kzalloc(buf_size, GFP_KERNEL);
+	if (!buf)
+		return -ENOMEM;
+
+	stats = kzalloc(sizeof(*stats), GFP_KERNEL);
+	if (!stats) {
+		kfree(buf);
+		return -ENOMEM;
+	}
+
+	dp_mst_sim_get_stats(debug->bridge.mst_ctx, stats);
+
+	len += scnprintf(buf + len, buf_size - len,
+			"%-18s %10s %12s %10s %10s\n",
+			"msg", "count", "bytes", "avg_us", "max_us");
+
+	for (i = 0; i < DP_MST_SIM_MSG_MAX; i++) {
+		msg = &stats->msg[i];
+		len += scnprintf(buf + len, buf_size - len,
+				"%-18s %10u %12llu %10llu %10u\n",
+				dp_sim_mst_msg_names[i], msg->count, msg->bytes,
+				msg->count ? div_u64(msg->total_us, msg->count) : 0,
+				msg->max_us);
+		msgs += msg->count;
+		bytes += msg->bytes;
+	}
+
+	elapsed_ms = max_t(u64, div_u64(stats->elapsed_us, 1000), 1);
+	len += scnprintf(buf + len, buf_size - len,
+			"elapsed_ms: %llu msgs/s: %llu bytes/s: %llu\n",
+			elapsed_ms, div64_u64(msgs * 1000, elapsed_ms),
+			div64_u64(bytes * 1000, elapsed_ms));
+
+	mutex_lock(&debug->lock);
+	len += scnprintf(buf + len, buf_size - len,
+			"load: remain=%u interval_ms=%u port_mask=0x%x\n",
+			debug->load_remain, debug->load_interval_ms,
+			debug->load_port_mask);
+	mutex_unlock(&debug->lock);
+
+	len = min_t(size_t, count, len);
+	if (!copy_to_user(user_buff, buf, len))
+		*ppos += len;
+
+	kfree(stats);
+	kfree(buf);
+	return len;
+}
+
+static ssize_t dp_sim_debug_write_mst_stats(struct file *file,
+		const char __user *user_buff, size_t count, loff_t *ppos)
+{
+	struct dp_sim_device *debug = file->private_data;
+
+	if (!debug)
+		return -ENODEV;
+
+	dp_mst_sim_reset_stats(debug->bridge.mst_ctx);
+
+	return count;
+}
+
+static const struct file_operations sim_mst_stats_fops = {
+	.open = simple_open,
+	.read = dp_sim_debug_read_mst_stats,
+	.write = dp_sim_debug_write_mst_stats,
+};
+
+/*
+ * Toggle the connection status of all ports in the load mask at once, each
+ * toggle makes the host re-probe the topology over sideband: connection
+ * notify, link address, remote i2c edid reads and payload allocation.
+ */
+static void dp_sim_load_work(struct work_struct *work)
+{
+	struct dp_sim_device *sim_dev = container_of(to_delayed_work(work),
+			struct dp_sim_device, load_work);
+	u32 i;
+
+	mutex_lock(&sim_dev->lock);
+
+	if (!sim_dev->load_remain)
+		goto end;
+
+	for (i = 0; i < sim_dev->current_port_num; i++) {
+		if (!(sim_dev->load_port_mask & BIT(i)))
+			continue;
+
+		sim_dev->ports[i].pdt =
+			(sim_dev->ports[i].pdt == DP_PEER_DEVICE_NONE) ?
+			DP_PEER_DEVICE_SST_SINK : DP_PEER_DEVICE_NONE;
+	}
+
+	dp_mst_sim_update(sim_dev->bridge.mst_ctx,
+			sim_dev->current_port_num, sim_dev->ports);
+
+	if (--sim_dev->load_remain)
+		schedule_delayed_work(&sim_dev->load_work,
+				msecs_to_jiffies(sim_dev->load_interval_ms));
+end:
+	mutex_unlock(&sim_dev->lock);
+}
+
+static ssize_t dp_sim_debug_write_mst_load(struct file *file,
+		const char __user *user_buff, size_t count, loff_t *ppos)
+{
+	struct dp_sim_device *debug = file->private_data;
+	char buf[SZ_32];
+	size_t len = 0;
+	u32 iterations = 0, interval_ms = 0, port_mask = 0, all_ports;
+	int argc;
+
+	if (!debug)
+		return -ENODEV;
+
+	/* Leave room for termination char */
+	len = min_t(size_t, count, SZ_32 - 1);
+	if (copy_from_user(buf, user_buff, len))
+		return -EFAULT;
+
+	buf[len] = '\0';
+
+	argc = sscanf(buf, "%u %u %x", &iterations, &interval_ms, &port_mask);
+	if (argc < 1 || (iterations && argc < 2)) {
+		DP_ERR("invalid input, expect <iterations> <interval_ms> [port_mask]\n");
+		return -EINVAL;
+	}
+
+	cancel_delayed_work_sync(&debug->load_work);
+
+	mutex_lock(&debug->lock);
+
+	all_ports = debug->current_port_num ?
+			GENMASK(debug->current_port_num - 1, 0) : 0;
+	if (argc < 3)
+		port_mask = all_ports;
+
+	debug->load_remain = iterations;
+	debug->load_interval_ms = interval_ms;
+	debug->load_port_mask = port_mask & all_ports;
+
+	DP_DEBUG("mst load: iterations:%u interval_ms:%u port_mask:0x%x\n",
+			iterations, interval_ms, debug->load_port_mask);
+
+	if (debug->load_remain && debug->load_port_mask)
+		schedule_delayed_work(&debug->load_work, 0);
+
+	mutex_unlock(&debug->lock);
+
+	return len;
+}
+
+static const struct file_operations sim_mst_load_fops = {
+	.open = simple_open,
+	.write = dp_sim_debug_write_mst_load,
+};
+
 static int dp_sim_debug_init(struct dp_sim_device *sim_dev)
 {
 	struct dp_sim_debug_edid_entry *edid_entry;
@@ -1541,6 +1730,30 @@ static int dp_sim_debug_init(struct dp_sim_device *sim_dev)
 		goto error_remove_dir;
 	}
 
+	file = debugfs_create_file("mst_stats",
+			0644,
+			dir,
+			sim_dev,
+			&sim_mst_stats_fops);
+	if (IS_ERR_OR_NULL(file)) {
+		rc = PTR_ERR(file);
+		DP_ERR("[%s] debugfs create failed, rc=%d\n",
+				sim_dev->label, rc);
+		goto error_remove_dir;
+	}
+
+	file = debugfs_create_file("mst_load",
+			0444,
+			dir,
+			sim_dev,
+			&sim_mst_load_fops);
+	if (IS_ERR_OR_NULL(file)) {
+		rc = PTR_ERR(file);
+		DP_ERR("[%s] debugfs create failed, rc=%d\n",
+				sim_dev->label, rc);
+		goto error_remove_dir;
+	}
+
 	sim_dev->debugfs_dir = dir;
 	sim_dev->debugfs_edid_dir = edid_dir;
 
@@ -1598,6 +1811,7 @@ int dp_sim_create_bridge(struct device *dev, struct dp_aux_bridge **bridge)
 	dp_sim_dev->bridge.flag = DP_AUX_BRIDGE_MST | DP_SIM_BRIDGE_PRIV_FLAG;
 	INIT_LIST_HEAD(&dp_sim_dev->dpcd_reg_list);
 	mutex_init(&dp_sim_dev->lock);
+	INIT_DELAYED_WORK(&dp_sim_dev->load_work, dp_sim_load_work);
 
 	memset(&cfg, 0, sizeof(cfg));
 	cfg.host_dev = dp_sim_dev;
@@ -1638,6 +1852,8 @@ int dp_sim_destroy_bridge(struct dp_aux_bridge *bridge)
 
 	dp_sim_dev = to_dp_sim_dev(bridge);
 
+	cancel_delayed_work_sync(&dp_sim_dev->load_work);
+
 	dp_mst_sim_destroy(dp_sim_dev->bridge.mst_ctx);
 
 	list_for_each_entry_safe(reg, p, &dp_sim_dev->dpcd_reg_list, head) {
@@ -38,6 +38,7 @@
 #include <linux/types.h>
 #include <linux/completion.h>
 #include <linux/delay.h>
+#include <linux/ktime.h>
 #include <linux/version.h>
 #include <drm/drm_fixed.h>
 #include <drm/drm_edid.h>
@@ -76,6 +77,9 @@ struct dp_mst_sim_context {
 	u8 esi[16];
 	u8 guid[16];
 	u8 dpcd[1024];
+
+	struct dp_mst_sim_stats stats;
+	ktime_t stats_start;
 };
 
 struct dp_mst_sim_work {
@@ -84,6 +88,7 @@ struct dp_mst_sim_work {
 	unsigned int address;
 	u8 buffer[256];
 	size_t size;
+	ktime_t start;
 };
 
 struct dp_mst_notify_work {
@@ -121,72 +126,76 @@ static void dp_sideband_hex_dump(const char *name,
 }
 #endif /* CONFIG_DYNAMIC_DEBUG */
 
+/*
+ * Sideband header CRC is CRC-4 with polynomial x^4 + x + 1 and the body
+ * CRC is CRC-8 with polynomial x^8 + x^7 + x^6 + x^4 + x^2 + 1, both MSB
+ * first with zero initial value. Look up one nibble / byte per step.
+ */
+static const u8 dp_mst_sim_crc4_table[16] = {
+	0x0, 0x3, 0x6, 0x5, 0xc, 0xf, 0xa, 0x9,
+	0xb, 0x8, 0xd, 0xe, 0x7, 0x4, 0x1, 0x2,
+};
+
+static const u8 dp_mst_sim_crc8_table[256] = {
+	0x00, 0xd5, 0x7f, 0xaa, 0xfe, 0x2b, 0x81, 0x54,
+	0x29, 0xfc, 0x56, 0x83, 0xd7, 0x02, 0xa8, 0x7d,
+	0x52, 0x87, 0x2d, 0xf8, 0xac, 0x79, 0xd3, 0x06,
+	0x7b, 0xae, 0x04, 0xd1, 0x85, 0x50, 0xfa, 0x2f,
+	0xa4, 0x71, 0xdb, 0x0e, 0x5a, 0x8f, 0x25, 0xf0,
+	0x8d, 0x58, 0xf2, 0x27, 0x73, 0xa6, 0x0c, 0xd9,
+	0xf6, 0x23, 0x89, 0x5c, 0x08, 0xdd, 0x77, 0xa2,
+	0xdf, 0x0a, 0xa0, 0x75, 0x21, 0xf4, 0x5e, 0x8b,
+	0x9d, 0x48, 0xe2, 0x37, 0x63, 0xb6, 0x1c, 0xc9,
+	0xb4, 0x61, 0xcb, 0x1e, 0x4a, 0x9f, 0x35, 0xe0,
+	0xcf, 0x1a, 0xb0, 0x65, 0x31, 0xe4, 0x4e, 0x9b,
+	0xe6, 0x33, 0x99, 0x4c, 0x18, 0xcd, 0x67, 0xb2,
+	0x39, 0xec, 0x46, 0x93, 0xc7, 0x12, 0xb8, 0x6d,
+	0x10, 0xc5, 0x6f, 0xba, 0xee, 0x3b, 0x91, 0x44,
+	0x6b, 0xbe, 0x14, 0xc1, 0x95, 0x40, 0xea, 0x3f,
+	0x42, 0x97, 0x3d, 0xe8, 0xbc, 0x69, 0xc3, 0x16,
+	0xef, 0x3a, 0x90, 0x45, 0x11, 0xc4, 0x6e, 0xbb,
+	0xc6, 0x13, 0xb9, 0x6c, 0x38, 0xed, 0x47, 0x92,
+	0xbd, 0x68, 0xc2, 0x17, 0x43, 0x96, 0x3c, 0xe9,
+	0x94, 0x41, 0xeb, 0x3e, 0x6a, 0xbf, 0x15, 0xc0,
+	0x4b, 0x9e, 0x34, 0xe1, 0xb5, 0x60, 0xca, 0x1f,
+	0x62, 0xb7, 0x1d, 0xc8, 0x9c, 0x49, 0xe3, 0x36,
+	0x19, 0xcc, 0x66, 0xb3, 0xe7, 0x32, 0x98, 0x4d,
+	0x30, 0xe5, 0x4f, 0x9a, 0xce, 0x1b, 0xb1, 0x64,
+	0x72, 0xa7, 0x0d, 0xd8, 0x8c, 0x59, 0xf3, 0x26,
+	0x5b, 0x8e, 0x24, 0xf1, 0xa5, 0x70, 0xda, 0x0f,
+	0x20, 0xf5, 0x5f, 0x8a, 0xde, 0x0b, 0xa1, 0x74,
+	0x09, 0xdc, 0x76, 0xa3, 0xf7, 0x22, 0x88, 0x5d,
+	0xd6, 0x03, 0xa9, 0x7c, 0x28, 0xfd, 0x57, 0x82,
+	0xff, 0x2a, 0x80, 0x55, 0x01, 0xd4, 0x7e, 0xab,
+	0x84, 0x51, 0xfb, 0x2e, 0x7a, 0xaf, 0x05, 0xd0,
+	0xad, 0x78, 0xd2, 0x07, 0x53, 0x86, 0x2c, 0xf9,
+};
+
 static u8 dp_mst_sim_msg_header_crc4(const uint8_t *data, size_t num_nibbles)
 {
-	u8 bitmask = 0x80;
-	u8 bitshift = 7;
-	u8 array_index = 0;
-	int number_of_bits = num_nibbles * 4;
 	u8 remainder = 0;
+	size_t i;
 
-	while (number_of_bits != 0) {
-		number_of_bits--;
-		remainder <<= 1;
-		remainder |= (data[array_index] & bitmask) >> bitshift;
-		bitmask >>= 1;
-		bitshift--;
-		if (bitmask == 0) {
-			bitmask = 0x80;
-			bitshift = 7;
-			array_index++;
-		}
-		if ((remainder & 0x10) == 0x10)
-			remainder ^= 0x13;
+	for (i = 0; i < num_nibbles / 2; i++) {
+		remainder = dp_mst_sim_crc4_table[remainder ^ (data[i] >> 4)];
+		remainder = dp_mst_sim_crc4_table[remainder ^ (data[i] & 0xf)];
 	}
 
-	number_of_bits = 4;
-	while (number_of_bits != 0) {
-		number_of_bits--;
-		remainder <<= 1;
-		if ((remainder & 0x10) != 0)
-			remainder ^= 0x13;
-	}
+	if (num_nibbles & 1)
+		remainder = dp_mst_sim_crc4_table[remainder ^ (data[i] >> 4)];
 
 	return remainder;
 }
 
 static u8 dp_mst_sim_msg_data_crc4(const uint8_t *data, u8 number_of_bytes)
 {
-	u8 bitmask = 0x80;
-	u8 bitshift = 7;
-	u8 array_index = 0;
-	int number_of_bits = number_of_bytes * 8;
-	u16 remainder = 0;
-
-	while (number_of_bits != 0) {
-		number_of_bits--;
-		remainder <<= 1;
-		remainder |= (data[array_index] & bitmask) >> bitshift;
-		bitmask >>= 1;
-		bitshift--;
-		if (bitmask == 0) {
-			bitmask = 0x80;
-			bitshift = 7;
-			array_index++;
-		}
-		if ((remainder & 0x100) == 0x100)
-			remainder ^= 0xd5;
-	}
+	u8 remainder = 0;
+	u8 i;
 
-	number_of_bits = 8;
-	while (number_of_bits != 0) {
-		number_of_bits--;
-		remainder <<= 1;
-		if ((remainder & 0x100) != 0)
-			remainder ^= 0xd5;
-	}
+	for (i = 0; i < number_of_bytes; i++)
+		remainder = dp_mst_sim_crc8_table[remainder ^ data[i]];
 
-	return remainder & 0xff;
+	return remainder;
 }
 
 static bool dp_mst_sim_decode_sideband_msg_hdr(struct drm_dp_sideband_msg_hdr *hdr,
@@ -733,13 +742,27 @@ static int dp_mst_sim_read_esi(struct dp_mst_sim_context *ctx,
 	return 0;
 }
 
+/* caller must hold session_lock */
+static void dp_mst_sim_update_stats(struct dp_mst_sim_context *ctx,
+		enum dp_mst_sim_msg_type type, u32 bytes, ktime_t start)
+{
+	struct dp_mst_sim_msg_stats *stats = &ctx->stats.msg[type];
+	u32 latency_us = ktime_us_delta(ktime_get(), start);
+
+	stats->count++;
+	stats->bytes += bytes;
+	stats->total_us += latency_us;
+	stats->max_us = max(stats->max_us, latency_us);
+}
+
 static int dp_mst_sim_down_req_internal(struct dp_mst_sim_context *ctx,
-		struct drm_dp_aux_msg *aux_msg)
+		struct drm_dp_aux_msg *aux_msg, ktime_t start)
 {
 	struct drm_dp_sideband_msg_rx *msg = &ctx->down_req;
 	struct drm_dp_sideband_msg_hdr hdr;
+	enum dp_mst_sim_msg_type type;
 	bool seqno;
-	int ret, size, len, hdr_len;
+	int ret, size, len, hdr_len, req_len;
 
 	ret = dp_get_one_sb_msg(msg, aux_msg);
 	if (!ret)
@@ -753,25 +776,32 @@ static int dp_mst_sim_down_req_internal(struct dp_mst_sim_context *ctx,
 	switch (msg->msg[0]) {
 	case DP_LINK_ADDRESS:
 		size = dp_sideband_build_link_address_rep(ctx);
+		type = DP_MST_SIM_MSG_LINK_ADDRESS;
 		break;
 	case DP_REMOTE_I2C_READ:
 		size = dp_sideband_build_remote_i2c_read_rep(ctx);
+		type = DP_MST_SIM_MSG_REMOTE_I2C_READ;
 		break;
 	case DP_ENUM_PATH_RESOURCES:
 		size = dp_sideband_build_enum_path_resources_rep(ctx);
+		type = DP_MST_SIM_MSG_ENUM_PATH_RESOURCES;
 		break;
 	case DP_ALLOCATE_PAYLOAD:
 		size = dp_sideband_build_allocate_payload_rep(ctx);
+		type = DP_MST_SIM_MSG_ALLOCATE_PAYLOAD;
 		break;
 	case DP_POWER_DOWN_PHY:
 	case DP_POWER_UP_PHY:
 		size = dp_sideband_build_power_updown_phy_rep(ctx);
+		type = DP_MST_SIM_MSG_POWER_UPDOWN_PHY;
 		break;
 	case DP_CLEAR_PAYLOAD_ID_TABLE:
 		size = dp_sideband_build_clear_payload_id_table_rep(ctx);
+		type = DP_MST_SIM_MSG_CLEAR_PAYLOAD_ID_TABLE;
 		break;
 	default:
 		size = dp_sideband_build_nak_rep(ctx);
+		type = DP_MST_SIM_MSG_OTHER;
 		break;
 	}
 
@@ -780,6 +810,7 @@ static int dp_mst_sim_down_req_internal(struct dp_mst_sim_context *ctx,
 			ctx->down_req.msg, ctx->down_req.curlen,
 			ctx->down_rep.msg, &size);
 
+	req_len = msg->curlen;
 	memset(msg, 0, sizeof(*msg));
 	msg = &ctx->down_rep;
 	msg->curlen = 0;
@@ -828,6 +859,9 @@ static int dp_mst_sim_down_req_internal(struct dp_mst_sim_context *ctx,
 		}
 	}
 
+	if (!ctx->reset_cnt)
+		dp_mst_sim_update_stats(ctx, type, req_len + size, start);
+
 	mutex_unlock(&ctx->session_lock);
 
 	return 0;
@@ -843,7 +877,7 @@ static void dp_mst_sim_down_req_work(struct work_struct *work)
 	msg.buffer = sim_work->buffer;
 	msg.size = sim_work->size;
 
-	dp_mst_sim_down_req_internal(sim_work->ctx, &msg);
+	dp_mst_sim_down_req_internal(sim_work->ctx, &msg, sim_work->start);
 
 	kfree(sim_work);
 }
@@ -870,6 +904,7 @@ static int dp_mst_sim_down_req(struct dp_mst_sim_context *ctx,
 	work->ctx = ctx;
 	work->address = aux_msg->address;
 	work->size = aux_msg->size;
+	work->start = ktime_get();
 	memcpy(work->buffer, aux_msg->buffer, aux_msg->size);
 
 	INIT_WORK(&work->base, dp_mst_sim_down_req_work);
@@ -991,6 +1026,7 @@ static void dp_mst_sim_up_req_work(struct work_struct *work)
 	struct drm_dp_sideband_msg_rx *msg = &ctx->down_rep;
 	struct drm_dp_sideband_msg_hdr hdr;
 	int len, hdr_len, i;
+	ktime_t start;
 
 	mutex_lock(&ctx->session_lock);
 
@@ -1001,6 +1037,7 @@ static void dp_mst_sim_up_req_work(struct work_struct *work)
 		if (!(notify_work->port_mask & (1 << i)))
 			continue;
 
+		start = ktime_get();
 		len = dp_sideband_build_connection_notify_req(ctx, i);
 
 		/* copy data */
@@ -1037,6 +1074,11 @@ static void dp_mst_sim_up_req_work(struct work_struct *work)
 			wait_for_completion(&ctx->session_comp);
 			mutex_lock(&ctx->session_lock);
 		}
+
+		if (!ctx->reset_cnt)
+			dp_mst_sim_update_stats(ctx,
+					DP_MST_SIM_MSG_CONNECTION_NOTIFY,
+					len, start);
 	}
 
 	mutex_unlock(&ctx->session_lock);
@@ -1162,6 +1204,7 @@ int dp_mst_sim_create(const struct dp_mst_sim_cfg *cfg,
 
 	mutex_init(&ctx->session_lock);
 	init_completion(&ctx->session_comp);
+	ctx->stats_start = ktime_get();
 
 	ctx->wq = create_singlethread_workqueue("dp_mst_sim");
 	if (IS_ERR_OR_NULL(ctx->wq)) {
@@ -1174,6 +1217,37 @@ int dp_mst_sim_create(const struct dp_mst_sim_cfg *cfg,
 	return 0;
 }
 
+int dp_mst_sim_get_stats(void *mst_sim_context,
+		struct dp_mst_sim_stats *stats)
+{
+	struct dp_mst_sim_context *ctx = mst_sim_context;
+
+	if (!ctx || !stats)
+		return -EINVAL;
+
+	mutex_lock(&ctx->session_lock);
+	*stats = ctx->stats;
+	stats->elapsed_us = ktime_us_delta(ktime_get(), ctx->stats_start);
+	mutex_unlock(&ctx->session_lock);
+
+	return 0;
+}
+
+int dp_mst_sim_reset_stats(void *mst_sim_context)
+{
+	struct dp_mst_sim_context *ctx = mst_sim_context;
+
+	if (!ctx)
+		return -EINVAL;
+
+	mutex_lock(&ctx->session_lock);
+	memset(&ctx->stats, 0, sizeof(ctx->stats));
+	ctx->stats_start = ktime_get();
+	mutex_unlock(&ctx->session_lock);
+
+	return 0;
+}
+
 int dp_mst_sim_destroy(void *mst_sim_context)
 {
 	struct dp_mst_sim_context *ctx = mst_sim_context;
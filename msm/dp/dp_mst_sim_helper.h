@@ -113,6 +113,48 @@ struct dp_mst_sim_cfg {
 			u8 *out, int *out_size);
 };
 
+/**
+ * enum dp_mst_sim_msg_type - sideband message types tracked by the simulator
+ */
+enum dp_mst_sim_msg_type {
+	DP_MST_SIM_MSG_LINK_ADDRESS,
+	DP_MST_SIM_MSG_ENUM_PATH_RESOURCES,
+	DP_MST_SIM_MSG_ALLOCATE_PAYLOAD,
+	DP_MST_SIM_MSG_REMOTE_I2C_READ,
+	DP_MST_SIM_MSG_POWER_UPDOWN_PHY,
+	DP_MST_SIM_MSG_CLEAR_PAYLOAD_ID_TABLE,
+	DP_MST_SIM_MSG_OTHER,
+	DP_MST_SIM_MSG_CONNECTION_NOTIFY,
+	DP_MST_SIM_MSG_MAX,
+};
+
+/**
+ * struct dp_mst_sim_msg_stats - statistics of one sideband message type
+ * @count: number of completed messages
+ * @bytes: sideband payload bytes of requests and replies
+ * @total_us: accumulated message latency
+ * @max_us: worst message latency
+ */
+struct dp_mst_sim_msg_stats {
+	u32 count;
+	u64 bytes;
+	u64 total_us;
+	u32 max_us;
+};
+
+/**
+ * struct dp_mst_sim_stats - sideband message statistics
+ * @msg: per message type statistics. Down requests are timed from the
+ *       last request chunk written by the host until the host cleared
+ *       the last reply, connection notifies from the start of the up
+ *       request until the host cleared it.
+ * @elapsed_us: time since the statistics were last reset
+ */
+struct dp_mst_sim_stats {
+	struct dp_mst_sim_msg_stats msg[DP_MST_SIM_MSG_MAX];
+	u64 elapsed_us;
+};
+
 /**
  * dp_mst_sim_create - Create simulator context
  * @cfg: see dp_mst_sim_cfg
@@ -147,5 +189,21 @@ int dp_mst_sim_transfer(void *mst_sim_context, struct drm_dp_aux_msg *msg);
 int dp_mst_sim_update(void *mst_sim_context, u32 port_num,
 		struct dp_mst_sim_port *ports);
 
+/**
+ * dp_mst_sim_get_stats - Get sideband message statistics
+ * @mst_sim_context: simulator context
+ * @stats: statistics returned
+ * return: 0 if successful
+ */
+int dp_mst_sim_get_stats(void *mst_sim_context,
+		struct dp_mst_sim_stats *stats);
+
+/**
+ * dp_mst_sim_reset_stats - Reset sideband message statistics
+ * @mst_sim_context: simulator context
+ * return: 0 if successful
+ */
+int dp_mst_sim_reset_stats(void *mst_sim_context);
+
 #endif /* _DP_MST_SIM_HELPER_H_ */
 
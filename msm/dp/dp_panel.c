@@ -6,6 +6,7 @@
 
 #include "dp_panel.h"
 #include <linux/unistd.h>
+#include <linux/crc32.h>
 #include <drm/drm_fixed.h>
 #include "dp_debug.h"
 #if (LINUX_VERSION_CODE >= KERNEL_VERSION(5, 19, 0))
@@ -28,6 +29,11 @@
 #define VSC_EXT_VESA_SDP_SUPPORTED BIT(4)
 #define VSC_EXT_VESA_SDP_CHAINING_SUPPORTED BIT(5)
 
+#define DDC_SEGMENT_ADDR 0x30
+
+/* number of solved transfer unit configurations remembered */
+#define DP_TU_CACHE_SIZE 16
+
 enum dp_panel_hdr_pixel_encoding {
 	RGB,
 	YCbCr444,
@@ -82,6 +88,14 @@ struct dp_panel_private {
 	u8 spd_product_description[16];
 	u8 major;
 	u8 minor;
+
+	struct work_struct edid_work;
+	struct completion edid_base_comp;
+	struct completion edid_comp;
+	struct drm_connector *edid_connector;
+	bool edid_base_valid;
+	bool edid_abort;
+	int edid_status;
 };
 
 /* OEM NAME */
@@ -1084,6 +1098,55 @@ static void _dp_panel_calc_tu(struct dp_tu_calc_input *in,
 	DP_DEBUG("TU: tu_size_minus1: %d\n", tu_table->tu_size_minus1);
 }
 
+/*
+ * The TU search only depends on its input, so solved configurations are
+ * kept in a small cache shared by all panels to avoid repeating it on
+ * hotplug and mode set of identical link and timing configurations.
+ */
+struct dp_tu_cache_entry {
+	struct dp_tu_calc_input in;
+	struct dp_vc_tu_mapping_table tu;
+	bool valid;
+};
+
+static struct dp_tu_cache_entry dp_tu_cache[DP_TU_CACHE_SIZE];
+static u32 dp_tu_cache_next;
+static DEFINE_SPINLOCK(dp_tu_cache_lock);
+
+static bool dp_panel_tu_cache_get(struct dp_tu_calc_input *in,
+		struct dp_vc_tu_mapping_table *tu_table)
+{
+	bool found = false;
+	int i;
+
+	spin_lock(&dp_tu_cache_lock);
+	for (i = 0; i < DP_TU_CACHE_SIZE; i++) {
+		if (dp_tu_cache[i].valid &&
+				!memcmp(&dp_tu_cache[i].in, in, sizeof(*in))) {
+			*tu_table = dp_tu_cache[i].tu;
+			found = true;
+			break;
+		}
+	}
+	spin_unlock(&dp_tu_cache_lock);
+
+	return found;
+}
+
+static void dp_panel_tu_cache_put(struct dp_tu_calc_input *in,
+		struct dp_vc_tu_mapping_table *tu_table)
+{
+	struct dp_tu_cache_entry *entry;
+
+	spin_lock(&dp_tu_cache_lock);
+	entry = &dp_tu_cache[dp_tu_cache_next];
+	dp_tu_cache_next = (dp_tu_cache_next + 1) % DP_TU_CACHE_SIZE;
+	entry->in = *in;
+	entry->tu = *tu_table;
+	entry->valid = true;
+	spin_unlock(&dp_tu_cache_lock);
+}
+
 static void dp_panel_calc_tu_parameters(struct dp_panel *dp_panel,
 		struct dp_vc_tu_mapping_table *tu_table)
 {
@@ -1096,6 +1159,8 @@ static void dp_panel_calc_tu_parameters(struct dp_panel *dp_panel,
 	pinfo = &dp_panel->pinfo;
 	bw_code = panel->link->link_params.bw_code;
 
+	/* the input is also the cache key, clear unused fields */
+	memset(&in, 0, sizeof(in));
 	in.lclk = drm_dp_bw_code_to_link_rate(bw_code) / 1000;
 	in.pclk_khz = pinfo->pixel_clk_khz;
 	in.hactive = pinfo->h_active;
@@ -1113,9 +1178,16 @@ static void dp_panel_calc_tu_parameters(struct dp_panel *dp_panel,
 		in.compress_ratio = mult_frac(100, pinfo->comp_info.src_bpp,
 				pinfo->comp_info.tgt_bpp);
 
+	if (dp_panel_tu_cache_get(&in, tu_table)) {
+		DP_DEBUG("TU: using cached parameters\n");
+		return;
+	}
+
 	_dp_panel_calc_tu(&in, tu_table);
+	dp_panel_tu_cache_put(&in, tu_table);
 }
 
+/* always runs the full search, bypassing the TU cache */
 void dp_panel_calc_tu_test(struct dp_tu_calc_input *in,
 		struct dp_vc_tu_mapping_table *tu_table)
 {
@@ -1719,12 +1791,170 @@ static int dp_panel_set_default_link_params(struct dp_panel *dp_panel)
 	return 0;
 }
 
-static int dp_panel_read_edid(struct dp_panel *dp_panel,
+static void dp_panel_set_edid_crc(struct dp_panel *dp_panel)
+{
+	struct edid *edid = dp_panel->edid_ctrl->edid;
+
+	dp_panel->edid_crc = edid ? crc32_le(~0, (const u8 *)edid,
+			EDID_LENGTH * (edid->extensions + 1)) : 0;
+}
+
+static void dp_panel_edid_publish_base(struct dp_panel_private *panel)
+{
+	if (completion_done(&panel->edid_base_comp))
+		return;
+
+	panel->dp_panel.edid_base_ts = ktime_get();
+	complete_all(&panel->edid_base_comp);
+}
+
+/*
+ * Read one EDID block per i2c transfer, so native AUX transactions from
+ * link training can interleave between blocks. drm_do_get_edid() only
+ * asks for an extension once the base block passed validation, which is
+ * when the base block is published to early consumers. Like the drm ddc
+ * block reader, a failed transfer is retried since sinks often NAK the
+ * first DDC access right after HPD.
+ */
+static int dp_panel_edid_read_block(void *data, u8 *buf, unsigned int block,
+	size_t len)
+{
+	struct dp_panel_private *panel = data;
+	unsigned char start = block * EDID_LENGTH;
+	unsigned char segment = block >> 1;
+	unsigned char xfers = segment ? 3 : 2;
+	int ret = -EIO, retries;
+	struct i2c_msg msgs[] = {
+		{
+			.addr	= DDC_SEGMENT_ADDR,
+			.flags	= 0,
+			.len	= 1,
+			.buf	= &segment,
+		}, {
+			.addr	= DDC_ADDR,
+			.flags	= 0,
+			.len	= 1,
+			.buf	= &start,
+		}, {
+			.addr	= DDC_ADDR,
+			.flags	= I2C_M_RD,
+			.len	= len,
+			.buf	= buf,
+		}
+	};
+
+	if (READ_ONCE(panel->edid_abort))
+		return -ECANCELED;
+
+	if (block == 1) {
+		panel->edid_base_valid = true;
+		dp_panel_edid_publish_base(panel);
+	}
+
+	for (retries = 5; retries; retries--) {
+		if (READ_ONCE(panel->edid_abort))
+			return -ECANCELED;
+
+		ret = i2c_transfer(&panel->aux->drm_aux->ddc,
+				&msgs[3 - xfers], xfers);
+		if (ret == -ENXIO) {
+			DP_DEBUG("edid block %u: no ddc response\n", block);
+			break;
+		}
+
+		if (ret == xfers)
+			break;
+	}
+
+	if (ret != xfers)
+		return -EIO;
+
+	if (!block)
+		memcpy(panel->dp_panel.edid_base, buf,
+				min_t(size_t, len, EDID_LENGTH));
+
+	return 0;
+}
+
+static void dp_panel_edid_work(struct work_struct *work)
+{
+	struct dp_panel_private *panel = container_of(work,
+			struct dp_panel_private, edid_work);
+	struct dp_panel *dp_panel = &panel->dp_panel;
+	struct edid *edid;
+	int rc = 0;
+
+	edid = drm_do_get_edid(panel->edid_connector,
+			dp_panel_edid_read_block, panel);
+	if (!edid) {
+		DP_ERR("panel edid read failed, set failsafe mode\n");
+		rc = -EINVAL;
+	} else {
+		/* no extension was read, base block is final */
+		if (!panel->edid_base_valid) {
+			memcpy(dp_panel->edid_base, edid, EDID_LENGTH);
+			panel->edid_base_valid = true;
+		}
+
+		dp_panel->edid_ctrl->edid = edid;
+		sde_parse_edid(dp_panel->edid_ctrl);
+	}
+
+	dp_panel_set_edid_crc(dp_panel);
+	dp_panel->audio_supported = drm_detect_monitor_audio(edid);
+	panel->edid_status = rc;
+	dp_panel_edid_publish_base(panel);
+
+	dp_panel->edid_ts = ktime_get();
+	complete_all(&panel->edid_comp);
+}
+
+static void dp_panel_cancel_edid(struct dp_panel_private *panel)
+{
+	WRITE_ONCE(panel->edid_abort, true);
+
+	/* release waiters if the fetch was cancelled before it started */
+	if (cancel_work_sync(&panel->edid_work)) {
+		panel->edid_status = -ECANCELED;
+		complete_all(&panel->edid_base_comp);
+		complete_all(&panel->edid_comp);
+	}
+}
+
+static void dp_panel_read_edid(struct dp_panel *dp_panel,
 	struct drm_connector *connector)
 {
-	int ret = 0;
 	struct dp_panel_private *panel;
-	struct edid *edid;
+
+	panel = container_of(dp_panel, struct dp_panel_private, dp_panel);
+
+	dp_panel_cancel_edid(panel);
+
+	reinit_completion(&panel->edid_base_comp);
+	reinit_completion(&panel->edid_comp);
+	panel->edid_connector = connector;
+	panel->edid_base_valid = false;
+	panel->edid_status = 0;
+	WRITE_ONCE(panel->edid_abort, false);
+
+	/* same checks drm_get_edid() does before reading */
+	if (connector->force == DRM_FORCE_OFF ||
+			!drm_probe_ddc(&panel->aux->drm_aux->ddc)) {
+		DP_ERR("panel edid read failed, set failsafe mode\n");
+		dp_panel->audio_supported = false;
+		panel->edid_status = -EINVAL;
+		dp_panel_edid_publish_base(panel);
+		dp_panel->edid_ts = ktime_get();
+		complete_all(&panel->edid_comp);
+		return;
+	}
+
+	queue_work(system_unbound_wq, &panel->edid_work);
+}
+
+static int dp_panel_wait_edid(struct dp_panel *dp_panel, bool base_only)
+{
+	struct dp_panel_private *panel;
 
 	if (!dp_panel) {
 		DP_ERR("invalid input\n");
@@ -1733,18 +1963,14 @@ static int dp_panel_read_edid(struct dp_panel *dp_panel,
 
 	panel = container_of(dp_panel, struct dp_panel_private, dp_panel);
 
-	sde_get_edid(connector, &panel->aux->drm_aux->ddc,
-		(void **)&dp_panel->edid_ctrl);
-	if (!dp_panel->edid_ctrl->edid) {
-		DP_ERR("EDID read failed\n");
-		ret = -EINVAL;
-		goto end;
+	if (base_only) {
+		wait_for_completion(&panel->edid_base_comp);
+		return panel->edid_base_valid ? 0 : -ENODATA;
 	}
-end:
-	edid = dp_panel->edid_ctrl->edid;
-	dp_panel->audio_supported = drm_detect_monitor_audio(edid);
 
-	return ret;
+	wait_for_completion(&panel->edid_comp);
+
+	return panel->edid_status;
 }
 
 static void dp_panel_decode_dsc_dpcd(struct dp_panel *dp_panel)
@@ -1873,11 +2099,8 @@ static int dp_panel_read_sink_caps(struct dp_panel *dp_panel,
 	if (panel->parser->has_mst && dp_panel->read_mst_cap(dp_panel))
 		goto skip_edid;
 
-	rc = dp_panel_read_edid(dp_panel, connector);
-	if (rc) {
-		DP_ERR("panel edid read failed, set failsafe mode\n");
-		return rc;
-	}
+	/* blocks are streamed while the rest of the connect sequence runs */
+	dp_panel_read_edid(dp_panel, connector);
 
 skip_edid:
 	dp_panel->widebus_en = panel->parser->has_widebus;
@@ -2039,10 +2262,13 @@ static int dp_panel_get_modes(struct dp_panel *dp_panel,
 	if (dp_panel->video_test) {
 		dp_panel_set_test_mode(panel, mode);
 		return 1;
-	} else if (dp_panel->edid_ctrl->edid) {
-		return _sde_edid_update_modes(connector, dp_panel->edid_ctrl);
 	}
 
+	dp_panel_wait_edid(dp_panel, false);
+
+	if (dp_panel->edid_ctrl->edid)
+		return _sde_edid_update_modes(connector, dp_panel->edid_ctrl);
+
 	return 0;
 }
 
@@ -2060,6 +2286,8 @@ static void dp_panel_handle_sink_request(struct dp_panel *dp_panel)
 	if (panel->link->sink_request & DP_TEST_LINK_EDID_READ) {
 		u8 checksum;
 
+		dp_panel_wait_edid(dp_panel, false);
+
 		if (dp_panel->edid_ctrl->edid)
 			checksum = sde_get_edid_checksum(dp_panel->edid_ctrl);
 		else
@@ -2357,12 +2585,15 @@ static int dp_panel_deinit_panel_info(struct dp_panel *dp_panel, u32 flags)
 	struct drm_connector *connector;
 	struct sde_connector_state *c_state;
 
+	panel = container_of(dp_panel, struct dp_panel_private, dp_panel);
+
+	dp_panel_cancel_edid(panel);
+
 	if (flags & DP_PANEL_SRC_INITIATED_POWER_DOWN) {
 		DP_DEBUG("retain states in src initiated power down request\n");
 		return 0;
 	}
 
-	panel = container_of(dp_panel, struct dp_panel_private, dp_panel);
 	hdr_meta = &panel->catalog->hdr_meta;
 	dhdr_vsif_sdp = &panel->catalog->dhdr_vsif_sdp;
 	shdr_if_sdp = &panel->catalog->shdr_if_sdp;
@@ -2373,6 +2604,7 @@ static int dp_panel_deinit_panel_info(struct dp_panel *dp_panel, u32 flags)
 
 	if (dp_panel->edid_ctrl->edid)
 		sde_free_edid((void **)&dp_panel->edid_ctrl);
+	dp_panel->edid_crc = 0;
 
 	dp_panel_set_stream_info(dp_panel, DP_STREAM_MAX, 0, 0, 0, 0);
 	memset(&dp_panel->pinfo, 0, sizeof(dp_panel->pinfo));
@@ -2908,6 +3140,7 @@ static int dp_panel_update_edid(struct dp_panel *dp_panel, struct edid *edid)
 
 	dp_panel->edid_ctrl->edid = edid;
 	sde_parse_edid(dp_panel->edid_ctrl);
+	dp_panel_set_edid_crc(dp_panel);
 
 	rc = _sde_edid_update_modes(dp_panel->connector, dp_panel->edid_ctrl);
 	dp_panel->audio_supported = drm_detect_monitor_audio(edid);
@@ -3205,6 +3438,13 @@ struct dp_panel *dp_panel_get(struct dp_panel_in *in)
 	dp_panel->get_sink_crc = dp_panel_get_sink_crc;
 	dp_panel->sink_crc_enable = dp_panel_sink_crc_enable;
 	dp_panel->get_panel_on = dp_panel_get_panel_on;
+	dp_panel->wait_edid = dp_panel_wait_edid;
+
+	INIT_WORK(&panel->edid_work, dp_panel_edid_work);
+	init_completion(&panel->edid_base_comp);
+	init_completion(&panel->edid_comp);
+	complete_all(&panel->edid_base_comp);
+	complete_all(&panel->edid_comp);
 
 	sde_conn = to_sde_connector(dp_panel->connector);
 	sde_conn->drv_panel = dp_panel;
@@ -3226,7 +3466,9 @@ void dp_panel_put(struct dp_panel *dp_panel)
 
 	panel = container_of(dp_panel, struct dp_panel_private, dp_panel);
 
+	dp_panel_cancel_edid(panel);
 	dp_panel_edid_deregister(panel);
+	kvfree(dp_panel->mode_cache);
 	sde_conn = to_sde_connector(dp_panel->connector);
 	if (sde_conn)
 		sde_conn->drv_panel = NULL;
@@ -106,6 +106,8 @@ struct dp_audio;
 
 #define DP_PANEL_CAPS_DSC	BIT(0)
 
+struct dp_mode_cache;
+
 struct dp_panel {
 	/* dpcd raw data */
 	u8 dpcd[DP_RECEIVER_CAP_SIZE + DP_RECEIVER_EXT_CAP_SIZE + 1];
@@ -168,6 +170,16 @@ struct dp_panel {
 
 	s64 fec_overhead_fp;
 
+	/* mode validation results, owned by the display module */
+	struct dp_mode_cache *mode_cache;
+
+	/* EDID is fetched in background, base block is published first */
+	u8 edid_base[EDID_LENGTH];
+	ktime_t edid_base_ts;
+	ktime_t edid_ts;
+	/* crc32 of the current EDID including extensions, 0 without one */
+	u32 edid_crc;
+
 	int (*init)(struct dp_panel *dp_panel);
 	int (*deinit)(struct dp_panel *dp_panel, u32 flags);
 	int (*hw_cfg)(struct dp_panel *dp_panel, bool enable);
@@ -202,6 +214,7 @@ struct dp_panel {
 	int (*get_src_crc)(struct dp_panel *dp_panel, u16 *crc);
 	int (*get_sink_crc)(struct dp_panel *dp_panel, u16 *crc);
 	bool (*get_panel_on)(struct dp_panel *dp_panel);
+	int (*wait_edid)(struct dp_panel *dp_panel, bool base_only);
 };
 
 struct dp_tu_calc_input {
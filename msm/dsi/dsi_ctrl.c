@@ -1183,39 +1183,27 @@ error:
 	return rc;
 }
 
-static int dsi_ctrl_copy_and_pad_cmd(struct dsi_ctrl *dsi_ctrl,
-				     const struct mipi_dsi_packet *packet,
-				     u8 **buffer,
-				     u32 *size)
+u32 dsi_ctrl_pack_cmd(const struct mipi_dsi_packet *packet, u8 *buf)
 {
-	int rc = 0;
-	u8 *buf = NULL;
-	u32 len, i;
+	u32 len;
 	u8 cmd_type = 0;
 
-	len = packet->size;
-	len += 0x3; len &= ~0x03; /* Align to 32 bits */
-
-	buf = devm_kzalloc(&dsi_ctrl->pdev->dev, len * sizeof(u8), GFP_KERNEL);
-	if (!buf)
-		return -ENOMEM;
-
-	for (i = 0; i < len; i++) {
-		if (i >= packet->size)
-			buf[i] = 0xFF;
-		else if (i < sizeof(packet->header))
-			buf[i] = packet->header[i];
-		else
-			buf[i] = packet->payload[i - sizeof(packet->header)];
-	}
-
-	if (packet->payload_length > 0)
-		buf[3] |= BIT(6);
+	len = ALIGN(packet->size, 4);
 
 	/* Swap BYTE order in the command buffer for MSM */
 	buf[0] = packet->header[1];
 	buf[1] = packet->header[2];
 	buf[2] = packet->header[0];
+	buf[3] = packet->header[3];
+
+	if (packet->payload_length > 0) {
+		memcpy(&buf[sizeof(packet->header)], packet->payload,
+				packet->payload_length);
+		buf[3] |= BIT(6);
+	}
+
+	if (len > packet->size)
+		memset(&buf[packet->size], 0xFF, len - packet->size);
 
 	/* send embedded BTA for read commands */
 	cmd_type = buf[2] & 0x3f;
@@ -1225,10 +1213,7 @@ static int dsi_ctrl_copy_and_pad_cmd(struct dsi_ctrl *dsi_ctrl,
 			(cmd_type == MIPI_DSI_GENERIC_READ_REQUEST_2_PARAM))
 		buf[3] |= BIT(5);
 
-	*buffer = buf;
-	*size = len;
-
-	return rc;
+	return len;
 }
 
 int dsi_ctrl_wait_for_cmd_mode_mdp_idle(struct dsi_ctrl *dsi_ctrl)
@@ -1494,8 +1479,6 @@ static int dsi_message_tx(struct dsi_ctrl *dsi_ctrl, struct dsi_cmd_desc *cmd_de
 	const struct mipi_dsi_msg *msg;
 	u32 length = 0;
 	u8 *buffer = NULL;
-	u32 cnt = 0;
-	u8 *cmdbuf;
 	u32 *flags;
 
 	msg = &cmd_desc->msg;
@@ -1532,20 +1515,17 @@ static int dsi_message_tx(struct dsi_ctrl *dsi_ctrl, struct dsi_cmd_desc *cmd_de
 		goto kickoff;
 	}
 
-	rc = mipi_dsi_create_packet(&packet, msg);
-	if (rc) {
-		DSI_CTRL_ERR(dsi_ctrl, "Failed to create message packet, rc=%d\n",
-				rc);
-		goto error;
-	}
+	if (cmd_desc->packed_buf) {
+		length = cmd_desc->packed_len;
+	} else {
+		rc = mipi_dsi_create_packet(&packet, msg);
+		if (rc) {
+			DSI_CTRL_ERR(dsi_ctrl, "Failed to create message packet, rc=%d\n",
+					rc);
+			goto error;
+		}
 
-	rc = dsi_ctrl_copy_and_pad_cmd(dsi_ctrl,
-			&packet,
-			&buffer,
-			&length);
-	if (rc) {
-		DSI_CTRL_ERR(dsi_ctrl, "failed to copy message, rc=%d\n", rc);
-		goto error;
+		length = ALIGN(packet.size, 4);
 	}
 
 	/*
@@ -1560,6 +1540,30 @@ static int dsi_message_tx(struct dsi_ctrl *dsi_ctrl, struct dsi_cmd_desc *cmd_de
 		}
 	}
 
+	/*
+	 * Embedded mode commands are packed straight into the DMA command
+	 * buffer, everything else goes through the preallocated FIFO
+	 * staging buffer.
+	 */
+	if (*flags & DSI_CTRL_CMD_FETCH_MEMORY) {
+		msm_gem_sync(dsi_ctrl->tx_cmd_buf);
+		buffer = (u8 *)(dsi_ctrl->vaddr) + dsi_ctrl->cmd_len;
+	} else {
+		if (length > sizeof(dsi_ctrl->fifo_cmd_buf)) {
+			DSI_CTRL_ERR(dsi_ctrl, "Cmd size %d exceeds fifo size\n",
+					length);
+			rc = -ENOTSUPP;
+			goto error;
+		}
+		buffer = (u8 *)dsi_ctrl->fifo_cmd_buf;
+	}
+
+	if (cmd_desc->packed_buf) {
+		memcpy(buffer, cmd_desc->packed_buf, length);
+	} else {
+		dsi_ctrl_pack_cmd(&packet, buffer);
+	}
+
 	if (*flags & DSI_CTRL_CMD_LAST_COMMAND)
 		buffer[3] |= BIT(7);//set the last cmd bit in header.
 
@@ -1573,12 +1577,6 @@ static int dsi_message_tx(struct dsi_ctrl *dsi_ctrl, struct dsi_cmd_desc *cmd_de
 		cmd_mem.use_lpm = (msg->flags & MIPI_DSI_MSG_USE_LPM) ?
 			true : false;
 
-		cmdbuf = (u8 *)(dsi_ctrl->vaddr);
-
-		msm_gem_sync(dsi_ctrl->tx_cmd_buf);
-		for (cnt = 0; cnt < length; cnt++)
-			cmdbuf[dsi_ctrl->cmd_len + cnt] = buffer[cnt];
-
 		dsi_ctrl->cmd_len += length;
 
 		if (*flags & DSI_CTRL_CMD_LAST_COMMAND) {
@@ -1602,8 +1600,6 @@ static int dsi_message_tx(struct dsi_ctrl *dsi_ctrl, struct dsi_cmd_desc *cmd_de
 kickoff:
 	dsi_kickoff_msg_tx(dsi_ctrl, msg, &cmd, &cmd_mem, *flags);
 error:
-	if (buffer)
-		devm_kfree(&dsi_ctrl->pdev->dev, buffer);
 	return rc;
 }
 
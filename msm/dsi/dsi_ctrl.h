@@ -57,6 +57,7 @@
 
 /* max size supported for dsi cmd transfer using TPG */
 #define DSI_CTRL_MAX_CMD_FIFO_STORE_SIZE 64
+#define DSI_CTRL_MAX_CMD_BATCH_SIZE SZ_4K
 
 /*Default tearcheck window size as programmed by MDP*/
 #define TEARCHECK_WINDOW_SIZE	5
@@ -218,6 +219,7 @@ struct dsi_ctrl_interrupts {
  * @cmd_buffer_iova:     cmd buffer mapped address.
  * @cmd_buffer_size:     Size of command buffer.
  * @vaddr:               CPU virtual address of cmd buffer.
+ * @fifo_cmd_buf:        Staging buffer used to pack FIFO store commands.
  * @secure_mode:         Indicates if secure-session is in progress
  * @esd_check_underway:  Indicates if esd status check is in progress
  * @post_cmd_tx_work:	 Work object to clean up post command transfer.
@@ -292,6 +294,7 @@ struct dsi_ctrl {
 	u32 cmd_buffer_iova;
 	u32 cmd_len;
 	void *vaddr;
+	u32 fifo_cmd_buf[DSI_CTRL_MAX_CMD_FIFO_STORE_SIZE / sizeof(u32)];
 	bool secure_mode;
 	bool esd_check_underway;
 	struct work_struct post_cmd_tx_work;
@@ -952,4 +955,17 @@ void dsi_ctrl_toggle_error_interrupt_status(struct dsi_ctrl *dsi_ctrl, bool enab
  * @dsi_ctrl:                 DSI controller handle.
  */
 void dsi_ctrl_transfer_cleanup(struct dsi_ctrl *dsi_ctrl);
+
+/**
+ * dsi_ctrl_pack_cmd() - serialize a packet into the MSM command format
+ * @packet:     MIPI DSI packet created from the message.
+ * @buf:        Destination, must hold at least ALIGN(packet->size, 4) bytes.
+ *
+ * Writes the header in the byte order expected by the controller followed
+ * by the payload and 0xFF padding up to the next 32-bit boundary. The
+ * LAST_COMMAND bit is left to the caller.
+ *
+ * Return: padded length of the packet in bytes.
+ */
+u32 dsi_ctrl_pack_cmd(const struct mipi_dsi_packet *packet, u8 *buf);
 #endif /* _DSI_CTRL_H_ */
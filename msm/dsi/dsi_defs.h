@@ -369,6 +369,9 @@ enum dsi_video_traffic_mode {
  * @ctrl:                index of DSI controller
  * @ctrl_flags:          controller flags
  * @ts:                  dsi command time stamp in nano-seconds.
+ * @packed_buf:          pre-serialized embedded mode packet, NULL if the
+ *                       command has to be packed at transfer time
+ * @packed_len:          padded length of @packed_buf in bytes
  */
 struct dsi_cmd_desc {
 	struct mipi_dsi_msg msg;
@@ -377,6 +380,8 @@ struct dsi_cmd_desc {
 	u32 ctrl;
 	u32 ctrl_flags;
 	ktime_t ts;
+	const u8 *packed_buf;
+	u32 packed_len;
 };
 
 /**
@@ -386,6 +391,12 @@ struct dsi_cmd_desc {
  * @count:     number of cmds
  * @ctrl_idx:  index of the dsi control
  * @cmds:      arry of cmds
+ * @packed_buf: pre-serialized packets of all cmds, built at parse time
+ * @packed_len: total length of @packed_buf in bytes
+ * @tx_count:  number of times the set was transmitted
+ * @tx_last_us: duration of the last transmission in micro-seconds
+ * @tx_max_us: longest transmission in micro-seconds
+ * @tx_total_us: accumulated transmission time in micro-seconds
  */
 struct dsi_panel_cmd_set {
 	enum dsi_cmd_set_type type;
@@ -393,6 +404,12 @@ struct dsi_panel_cmd_set {
 	u32 count;
 	u32 ctrl_idx;
 	struct dsi_cmd_desc *cmds;
+	u8 *packed_buf;
+	u32 packed_len;
+	u32 tx_count;
+	u32 tx_last_us;
+	u32 tx_max_us;
+	u64 tx_total_us;
 };
 
 /**
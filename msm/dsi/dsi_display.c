@@ -1971,6 +1971,47 @@ static const struct file_operations dsi_command_scheduling_fops = {
 	.read = debugfs_read_cmd_scheduling_params,
 };
 
+static ssize_t debugfs_read_cmd_set_stats(struct file *file,
+				 char __user *user_buf,
+				 size_t user_len,
+				 loff_t *ppos)
+{
+	struct dsi_display *display = file->private_data;
+	char *buf;
+	int len = 0;
+	size_t max_len = min_t(size_t, user_len, SZ_4K);
+
+	if (!display || !display->panel)
+		return -ENODEV;
+
+	if (*ppos)
+		return 0;
+
+	buf = kzalloc(max_len, GFP_KERNEL);
+	if (ZERO_OR_NULL_PTR(buf))
+		return -ENOMEM;
+
+	len = dsi_panel_dump_cmd_set_stats(display->panel, buf, max_len);
+	if (len < 0)
+		goto error;
+
+	if (copy_to_user(user_buf, buf, len)) {
+		len = -EFAULT;
+		goto error;
+	}
+
+	*ppos += len;
+
+error:
+	kfree(buf);
+	return len;
+}
+
+static const struct file_operations dsi_cmd_set_stats_fops = {
+	.open = simple_open,
+	.read = debugfs_read_cmd_set_stats,
+};
+
 static int dsi_display_debugfs_init(struct dsi_display *display)
 {
 	int rc = 0;
@@ -2040,6 +2081,18 @@ static int dsi_display_debugfs_init(struct dsi_display *display)
 		goto error_remove_dir;
 	}
 
+	dump_file = debugfs_create_file("cmd_set_stats",
+					0400,
+					dir,
+					display,
+					&dsi_cmd_set_stats_fops);
+	if (IS_ERR_OR_NULL(dump_file)) {
+		rc = PTR_ERR(dump_file);
+		DSI_ERR("[%s] debugfs for cmd set stats file failed, rc=%d\n",
+		       display->name, rc);
+		goto error_remove_dir;
+	}
+
 	misr_data = debugfs_create_file("misr_data",
 					0600,
 					dir,
@@ -3479,7 +3532,7 @@ error:
 static ssize_t dsi_host_transfer(struct mipi_dsi_host *host, const struct mipi_dsi_msg *msg)
 {
 	int rc = 0;
-	struct dsi_cmd_desc cmd;
+	struct dsi_cmd_desc cmd = {};
 
 	if (!msg) {
 		DSI_ERR("Invalid params\n");
@@ -12,6 +12,7 @@
 #include <video/mipi_display.h>
 
 #include "dsi_panel.h"
+#include "dsi_ctrl.h"
 #include "dsi_ctrl_hw.h"
 #include "dsi_parser.h"
 #include "sde_dbg.h"
@@ -426,24 +427,59 @@ static int dsi_panel_power_off(struct dsi_panel *panel)
 
 	return rc;
 }
+
+/*
+ * Decide whether command @i of a set is batched with the command after it
+ * into one DMA kickoff. A batch is closed on the last command of the set,
+ * on commands with an explicit post wait, before and after commands that
+ * are not sent in embedded mode, when the destination controller or the
+ * broadcast mode changes and when the next command would overflow the DMA
+ * buffer. The command closing a batch is sent and waited for like any
+ * unbatched command, so no batch is left in flight on a controller when
+ * the set moves on to another one.
+ */
+static bool dsi_panel_cmd_batch_next(struct dsi_panel_cmd_set *set, u32 i,
+		u32 *len)
+{
+	struct dsi_cmd_desc *cmd = &set->cmds[i];
+	struct dsi_cmd_desc *next;
+
+	next = (i + 1 < set->count) ? &set->cmds[i + 1] : NULL;
+
+	*len += cmd->packed_len;
+	if (!next || !cmd->packed_buf || !next->packed_buf ||
+			cmd->post_wait_ms || (cmd->ctrl != next->ctrl) ||
+			((cmd->msg.flags ^ next->msg.flags) &
+				MIPI_DSI_MSG_UNICAST_COMMAND) ||
+			(*len + next->packed_len) > DSI_CTRL_MAX_CMD_BATCH_SIZE) {
+		*len = 0;
+		return false;
+	}
+
+	return true;
+}
+
 static int dsi_panel_tx_cmd_set(struct dsi_panel *panel,
 				enum dsi_cmd_set_type type)
 {
 	int rc = 0, i = 0;
 	ssize_t len;
-	struct dsi_cmd_desc *cmds;
-	u32 count;
+	struct dsi_cmd_desc *cmds, *cmd, batch_cmd;
+	struct dsi_panel_cmd_set *set;
+	u32 count, tx_us, batch_len = 0;
 	enum dsi_cmd_set_state state;
 	struct dsi_display_mode *mode;
+	ktime_t start;
 
 	if (!panel || !panel->cur_mode)
 		return -EINVAL;
 
 	mode = panel->cur_mode;
 
-	cmds = mode->priv_info->cmd_sets[type].cmds;
-	count = mode->priv_info->cmd_sets[type].count;
-	state = mode->priv_info->cmd_sets[type].state;
+	set = &mode->priv_info->cmd_sets[type];
+	cmds = set->cmds;
+	count = set->count;
+	state = set->state;
 	SDE_EVT32(type, state, count);
 
 	if (count == 0) {
@@ -452,6 +488,7 @@ static int dsi_panel_tx_cmd_set(struct dsi_panel *panel,
 		goto error;
 	}
 
+	start = ktime_get();
 	for (i = 0; i < count; i++) {
 		cmds->ctrl_flags = 0;
 
@@ -461,7 +498,18 @@ static int dsi_panel_tx_cmd_set(struct dsi_panel *panel,
 		if (type == DSI_CMD_SET_VID_SWITCH_OUT)
 			cmds->msg.flags |= MIPI_DSI_MSG_ASYNC_OVERRIDE;
 
-		len = dsi_host_transfer_sub(panel->host, cmds);
+		/* batch flags are per transfer, keep the parsed set intact */
+		cmd = cmds;
+		if (panel->cmd_batch_en) {
+			batch_cmd = *cmds;
+			if (dsi_panel_cmd_batch_next(set, i, &batch_len))
+				batch_cmd.msg.flags |= MIPI_DSI_MSG_BATCH_COMMAND;
+			else
+				batch_cmd.msg.flags &= ~MIPI_DSI_MSG_BATCH_COMMAND;
+			cmd = &batch_cmd;
+		}
+
+		len = dsi_host_transfer_sub(panel->host, cmd);
 		if (len < 0) {
 			rc = len;
 			DSI_ERR("failed to set cmds(%d), rc=%d\n", type, rc);
@@ -472,6 +520,12 @@ static int dsi_panel_tx_cmd_set(struct dsi_panel *panel,
 					((cmds->post_wait_ms*1000)+10));
 		cmds++;
 	}
+
+	tx_us = ktime_us_delta(ktime_get(), start);
+	set->tx_count++;
+	set->tx_last_us = tx_us;
+	set->tx_max_us = max(set->tx_max_us, tx_us);
+	set->tx_total_us += tx_us;
 error:
 	return rc;
 }
@@ -1921,6 +1975,37 @@ const char *cmd_set_state_map[DSI_CMD_SET_MAX] = {
 	"qcom,mdss-dsi-qsync-off-commands-state",
 };
 
+int dsi_panel_dump_cmd_set_stats(struct dsi_panel *panel, char *buf,
+		size_t size)
+{
+	struct dsi_panel_cmd_set *set;
+	int len = 0;
+	u32 i;
+
+	if (!panel || !buf)
+		return -EINVAL;
+
+	mutex_lock(&panel->panel_lock);
+	if (!panel->cur_mode || !panel->cur_mode->priv_info)
+		goto end;
+
+	for (i = DSI_CMD_SET_PRE_ON; i < DSI_CMD_SET_MAX; i++) {
+		set = &panel->cur_mode->priv_info->cmd_sets[i];
+		if (!set->tx_count)
+			continue;
+
+		len += scnprintf(buf + len, size - len,
+			"%s: cnt:%u packed:%u last:%uus max:%uus avg:%lluus\n",
+			cmd_set_prop_map[i], set->tx_count, set->packed_len,
+			set->tx_last_us, set->tx_max_us,
+			div_u64(set->tx_total_us, set->tx_count));
+	}
+end:
+	mutex_unlock(&panel->panel_lock);
+
+	return len;
+}
+
 int dsi_panel_get_cmd_pkt_count(const char *data, u32 length, u32 *cnt)
 {
 	const u32 cmd_set_min_size = 7;
@@ -2002,7 +2087,67 @@ void dsi_panel_destroy_cmd_packets(struct dsi_panel_cmd_set *set)
 	for (i = 0; i < set->count; i++) {
 		cmd = &set->cmds[i];
 		kfree(cmd->msg.tx_buf);
+		cmd->packed_buf = NULL;
+		cmd->packed_len = 0;
 	}
+
+	kfree(set->packed_buf);
+	set->packed_buf = NULL;
+	set->packed_len = 0;
+}
+
+/*
+ * Serialize all embedded mode commands of a set into one blob so that the
+ * controller can copy them into the DMA buffer without re-packing on every
+ * transfer. Commands exceeding the embedded mode limit are sent in
+ * non-embedded mode straight from msg.tx_buf and are left unpacked. The
+ * last command bit is left clear, the controller sets it at transfer time.
+ */
+static int dsi_panel_pack_cmd_set(struct dsi_panel_cmd_set *set)
+{
+	int rc = 0;
+	u32 i, len = 0, offset = 0;
+	struct dsi_cmd_desc *cmd;
+	struct mipi_dsi_packet packet;
+
+	for (i = 0; i < set->count; i++) {
+		cmd = &set->cmds[i];
+		if (cmd->msg.tx_len > DSI_EMBEDDED_MODE_DMA_MAX_SIZE_BYTES)
+			continue;
+
+		rc = mipi_dsi_create_packet(&packet, &cmd->msg);
+		if (rc) {
+			DSI_ERR("invalid cmd %d of set %d, rc=%d\n",
+					i, set->type, rc);
+			return rc;
+		}
+
+		len += ALIGN(packet.size, 4);
+	}
+
+	if (!len)
+		return 0;
+
+	set->packed_buf = kzalloc(len, GFP_KERNEL);
+	if (!set->packed_buf)
+		return -ENOMEM;
+
+	for (i = 0; i < set->count; i++) {
+		cmd = &set->cmds[i];
+		if (cmd->msg.tx_len > DSI_EMBEDDED_MODE_DMA_MAX_SIZE_BYTES)
+			continue;
+
+		mipi_dsi_create_packet(&packet, &cmd->msg);
+		cmd->packed_buf = &set->packed_buf[offset];
+		cmd->packed_len = dsi_ctrl_pack_cmd(&packet,
+				&set->packed_buf[offset]);
+
+		offset += cmd->packed_len;
+	}
+
+	set->packed_len = len;
+
+	return 0;
 }
 
 void dsi_panel_dealloc_cmd_packets(struct dsi_panel_cmd_set *set)
@@ -2067,6 +2212,13 @@ static int dsi_panel_parse_cmd_sets_sub(struct dsi_panel_cmd_set *cmd,
 		goto error_free_mem;
 	}
 
+	rc = dsi_panel_pack_cmd_set(cmd);
+	if (rc) {
+		DSI_ERR("[%s] failed to pack cmd packets, rc=%d\n",
+				cmd_set_prop_map[type], rc);
+		goto error_free_packets;
+	}
+
 	state = utils->get_property(utils->data, cmd_set_state_map[type], NULL);
 	if (!state || !strcmp(state, "dsi_lp_mode")) {
 		cmd->state = DSI_CMD_SET_STATE_LP;
@@ -2075,10 +2227,12 @@ static int dsi_panel_parse_cmd_sets_sub(struct dsi_panel_cmd_set *cmd,
 	} else {
 		DSI_ERR("[%s] command state unrecognized-%s\n",
 		       cmd_set_state_map[type], state);
-		goto error_free_mem;
+		goto error_free_packets;
 	}
 
 	return rc;
+error_free_packets:
+	dsi_panel_destroy_cmd_packets(cmd);
 error_free_mem:
 	kfree(cmd->cmds);
 	cmd->cmds = NULL;
@@ -2220,6 +2374,9 @@ static int dsi_panel_parse_misc_features(struct dsi_panel *panel)
 	panel->lp11_init = utils->read_bool(utils->data,
 			"qcom,mdss-dsi-lp11-init");
 
+	panel->cmd_batch_en = utils->read_bool(utils->data,
+			"qcom,mdss-dsi-cmd-batch-enabled");
+
 	panel->reset_gpio_always_on = utils->read_bool(utils->data,
 			"qcom,platform-reset-gpio-always-on");
 
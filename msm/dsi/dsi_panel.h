@@ -268,6 +268,7 @@ struct dsi_panel {
 	struct dsi_panel_spr_info spr_info;
 
 	bool sync_broadcast_en;
+	bool cmd_batch_en;
 	u32 dsc_count;
 	u32 lm_count;
 
@@ -412,4 +413,16 @@ int dsi_panel_create_cmd_packets(const char *data, u32 length, u32 count,
 void dsi_panel_destroy_cmd_packets(struct dsi_panel_cmd_set *set);
 
 void dsi_panel_dealloc_cmd_packets(struct dsi_panel_cmd_set *set);
+
+/**
+ * dsi_panel_dump_cmd_set_stats() - print transfer timing of the command
+ *				    sets of the current mode
+ * @panel:	DSI panel handle.
+ * @buf:	Output buffer.
+ * @size:	Size of the output buffer.
+ *
+ * Return: number of bytes written to @buf or error code.
+ */
+int dsi_panel_dump_cmd_set_stats(struct dsi_panel *panel, char *buf,
+		size_t size);
 #endif /* _DSI_PANEL_H_ */
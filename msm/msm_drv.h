@@ -1371,6 +1371,10 @@ int msm_framebuffer_set_cache_hint(struct drm_framebuffer *fb,
 		u32 flags, u32 rd_type, u32 wr_type);
 int msm_framebuffer_get_cache_hint(struct drm_framebuffer *fb,
 		u32 *flags, u32 *rd_type, u32 *wr_type);
+int msm_framebuffer_get_layout(struct drm_framebuffer *fb,
+		void *layout, size_t size);
+int msm_framebuffer_set_layout(struct drm_framebuffer *fb,
+		const void *layout, size_t size);
 
 static inline struct drm_fb_helper *msm_fbdev_init(struct drm_device *dev)
 {
@@ -33,12 +33,23 @@ struct msm_framebuffer {
 	u32 cache_flags;
 	u32 cache_rd_type;
 	u32 cache_wr_type;
+	spinlock_t layout_lock;
+	void *layout;
+	size_t layout_size;
 };
 #define to_msm_framebuffer(x) container_of(x, struct msm_framebuffer, base)
 
+static void msm_framebuffer_destroy(struct drm_framebuffer *fb)
+{
+	struct msm_framebuffer *msm_fb = to_msm_framebuffer(fb);
+
+	kfree(msm_fb->layout);
+	drm_gem_fb_destroy(fb);
+}
+
 static const struct drm_framebuffer_funcs msm_framebuffer_funcs = {
 	.create_handle = drm_gem_fb_create_handle,
-	.destroy = drm_gem_fb_destroy,
+	.destroy = msm_framebuffer_destroy,
 	.dirty = drm_atomic_helper_dirtyfb,
 };
 
@@ -211,6 +222,7 @@ struct drm_framebuffer *msm_framebuffer_init(struct drm_device *dev,
 	fb = &msm_fb->base;
 
 	msm_fb->format = format;
+	spin_lock_init(&msm_fb->layout_lock);
 
 	if (mode_cmd->flags & DRM_MODE_FB_MODIFIERS) {
 		for (i = 0; i < ARRAY_SIZE(mode_cmd->modifier); i++) {
@@ -316,3 +328,53 @@ int  msm_framebuffer_get_cache_hint(struct drm_framebuffer *fb,
 
 	return 0;
 }
+
+int msm_framebuffer_get_layout(struct drm_framebuffer *fb,
+		void *layout, size_t size)
+{
+	struct msm_framebuffer *msm_fb;
+	int ret = -ENOENT;
+
+	if (!fb || !layout)
+		return -EINVAL;
+
+	msm_fb = to_msm_framebuffer(fb);
+
+	spin_lock(&msm_fb->layout_lock);
+	if (msm_fb->layout && msm_fb->layout_size == size) {
+		memcpy(layout, msm_fb->layout, size);
+		ret = 0;
+	}
+	spin_unlock(&msm_fb->layout_lock);
+
+	return ret;
+}
+
+int msm_framebuffer_set_layout(struct drm_framebuffer *fb,
+		const void *layout, size_t size)
+{
+	struct msm_framebuffer *msm_fb;
+	void *cache;
+
+	if (!fb || !layout)
+		return -EINVAL;
+
+	msm_fb = to_msm_framebuffer(fb);
+
+	cache = kmemdup(layout, size, GFP_KERNEL);
+	if (!cache)
+		return -ENOMEM;
+
+	/* the layout never changes for a given fb, keep the first one */
+	spin_lock(&msm_fb->layout_lock);
+	if (!msm_fb->layout) {
+		msm_fb->layout = cache;
+		msm_fb->layout_size = size;
+		cache = NULL;
+	}
+	spin_unlock(&msm_fb->layout_lock);
+
+	kfree(cache);
+
+	return 0;
+}
@@ -18,7 +18,6 @@
  */
 
 #define pr_fmt(fmt)	"[drm:%s:%d] " fmt, __func__, __LINE__
-#include <linux/sort.h>
 #include <linux/debugfs.h>
 #include <linux/ktime.h>
 #include <drm/sde_drm.h>
@@ -1650,33 +1649,57 @@ struct plane_state {
 	const struct drm_plane_state *drm_pstate;
 	int stage;
 	u32 pipe_id;
+
+	/* sort keys, captured by _sde_crtc_sort_pstates */
+	int zpos;
+	enum sde_layout layout;
+	int crtc_x;
 };
 
-static int pstate_cmp(const void *a, const void *b)
+static int pstate_cmp(const struct plane_state *pa,
+		const struct plane_state *pb)
 {
-	struct plane_state *pa = (struct plane_state *)a;
-	struct plane_state *pb = (struct plane_state *)b;
 	int rc = 0;
-	int pa_zpos, pb_zpos;
-	enum sde_layout pa_layout, pb_layout;
 
-	if ((!pa || !pa->sde_pstate) || (!pb || !pb->sde_pstate))
-		return rc;
+	if (pa->zpos != pb->zpos)
+		rc = pa->zpos - pb->zpos;
+	else if (pa->layout != pb->layout)
+		rc = pa->layout - pb->layout;
+	else
+		rc = pa->crtc_x - pb->crtc_x;
 
-	pa_zpos = sde_plane_get_property(pa->sde_pstate, PLANE_PROP_ZPOS);
-	pb_zpos = sde_plane_get_property(pb->sde_pstate, PLANE_PROP_ZPOS);
+	return rc;
+}
 
-	pa_layout = pa->sde_pstate->layout;
-	pb_layout = pb->sde_pstate->layout;
+/*
+ * Order plane states by zpos, layout and crtc_x. The keys are looked up
+ * once per plane instead of on every comparison; insertion sort is stable
+ * and linear when the planes are already in order.
+ */
+static void _sde_crtc_sort_pstates(struct plane_state *pstates, int cnt)
+{
+	struct plane_state tmp;
+	int i, j;
 
-	if (pa_zpos != pb_zpos)
-		rc = pa_zpos - pb_zpos;
-	else if (pa_layout != pb_layout)
-		rc = pa_layout - pb_layout;
-	else
-		rc = pa->drm_pstate->crtc_x - pb->drm_pstate->crtc_x;
+	for (i = 0; i < cnt; i++) {
+		if (!pstates[i].sde_pstate || !pstates[i].drm_pstate)
+			continue;
 
-	return rc;
+		pstates[i].zpos = sde_plane_get_property(pstates[i].sde_pstate,
+				PLANE_PROP_ZPOS);
+		pstates[i].layout = pstates[i].sde_pstate->layout;
+		pstates[i].crtc_x = pstates[i].drm_pstate->crtc_x;
+	}
+
+	for (i = 1; i < cnt; i++) {
+		if (pstate_cmp(&pstates[i - 1], &pstates[i]) <= 0)
+			continue;
+
+		tmp = pstates[i];
+		for (j = i; j > 0 && pstate_cmp(&pstates[j - 1], &tmp) > 0; j--)
+			pstates[j] = pstates[j - 1];
+		pstates[j] = tmp;
+	}
 }
 
 /*
@@ -2025,7 +2048,7 @@ static void _sde_crtc_blend_setup_mixer(struct drm_crtc *crtc,
 	if (ctl->ops.set_active_pipes)
 		ctl->ops.set_active_pipes(ctl, fetch_active);
 
-	sort(pstates, cnt, sizeof(pstates[0]), pstate_cmp, NULL);
+	_sde_crtc_sort_pstates(pstates, cnt);
 	_sde_crtc_set_src_split_order(crtc, pstates, cnt);
 
 	if (lm && lm->ops.setup_dim_layer) {
@@ -4758,6 +4781,9 @@ int sde_crtc_reset_hw(struct drm_crtc *crtc, struct drm_crtc_state *old_state,
 	/* optionally generate a panic instead of performing a h/w reset */
 	SDE_DBG_CTRL("stop_ftrace", "reset_hw_panic");
 
+	/* reset may return registers to their defaults */
+	sde_reg_shadow_invalidate_all();
+
 	for (i = 0; i < sde_crtc->num_ctls; ++i) {
 		ctl = sde_crtc->mixers[i].hw_ctl;
 		if (!ctl || !ctl->ops.reset)
@@ -6066,7 +6092,7 @@ static int _sde_crtc_check_zpos(struct drm_crtc_state *state,
 		return -EINVAL;
 	}
 
-	sort(pstates, cnt, sizeof(pstates[0]), pstate_cmp, NULL);
+	_sde_crtc_sort_pstates(pstates, cnt);
 
 	rc = _sde_crtc_excl_dim_layer_check(crtc, state, pstates, cnt);
 	if (rc)
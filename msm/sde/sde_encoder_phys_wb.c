@@ -557,7 +557,7 @@ static void sde_encoder_phys_wb_setup_fb(struct sde_encoder_phys *phys_enc,
 	}
 	wb_cfg->roi = *wb_roi;
 
-	ret = sde_format_populate_layout(aspace, fb, &wb_cfg->dest);
+	ret = sde_format_populate_layout(aspace, fb, &wb_cfg->dest, NULL);
 	if (ret) {
 		SDE_DEBUG("[enc:%d wb:%d] failed to populate layout; ret:%d\n",
 				DRMID(phys_enc->parent), WBID(wb_enc), ret);
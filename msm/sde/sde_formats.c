@@ -9,6 +9,7 @@
 #include <drm/drm_fourcc.h>
 #include <media/mmm_color_fmt.h>
 #include <linux/sort.h>
+#include <linux/hash.h>
 
 #include "sde_kms.h"
 #include "sde_formats.h"
@@ -1092,7 +1093,8 @@ static int _sde_format_populate_addrs_linear(
 int sde_format_populate_layout(
 		struct msm_gem_address_space *aspace,
 		struct drm_framebuffer *fb,
-		struct sde_hw_fmt_layout *layout)
+		struct sde_hw_fmt_layout *layout,
+		bool *cache_hit)
 {
 	uint32_t plane_addr[SDE_MAX_PLANES];
 	int i, ret;
@@ -1108,13 +1110,27 @@ int sde_format_populate_layout(
 		return -ERANGE;
 	}
 
-	layout->format = to_sde_format(msm_framebuffer_format(fb));
+	/*
+	 * Plane sizes only depend on the format, modifier, dimensions and
+	 * pitches of the fb which never change, so they are computed once
+	 * and cached in the fb until it is destroyed.
+	 */
+	if (!msm_framebuffer_get_layout(fb, layout, sizeof(*layout))) {
+		if (cache_hit)
+			*cache_hit = true;
+	} else {
+		layout->format = to_sde_format(msm_framebuffer_format(fb));
 
-	/* Populate the plane sizes etc via get_format */
-	ret = sde_format_get_plane_sizes(layout->format, fb->width, fb->height,
-			layout, fb->pitches);
-	if (ret)
-		return ret;
+		/* Populate the plane sizes etc via get_format */
+		ret = sde_format_get_plane_sizes(layout->format, fb->width,
+				fb->height, layout, fb->pitches);
+		if (ret)
+			return ret;
+
+		msm_framebuffer_set_layout(fb, layout, sizeof(*layout));
+		if (cache_hit)
+			*cache_hit = false;
+	}
 
 	for (i = 0; i < SDE_MAX_PLANES; ++i)
 		plane_addr[i] = layout->plane_addr[i];
@@ -1178,11 +1194,118 @@ int sde_format_check_modified_format(
 	return 0;
 }
 
+#define SDE_FORMAT_HASH_BITS	8
+#define SDE_FORMAT_HASH_SIZE	BIT(SDE_FORMAT_HASH_BITS)
+
+/*
+ * struct sde_format_map_desc - format map and its number of entries
+ * @map: format map
+ * @size: number of entries in the map
+ */
+struct sde_format_map_desc {
+	const struct sde_format *map;
+	size_t size;
+};
+
+#define SDE_FORMAT_MAP_DESC(m) { .map = (m), .size = ARRAY_SIZE(m) }
+
+static const struct sde_format_map_desc sde_format_maps[] = {
+	SDE_FORMAT_MAP_DESC(sde_format_map),
+	SDE_FORMAT_MAP_DESC(sde_format_map_alpha_swap),
+	SDE_FORMAT_MAP_DESC(sde_format_map_tile),
+	SDE_FORMAT_MAP_DESC(sde_format_map_p010_tile),
+	SDE_FORMAT_MAP_DESC(sde_format_map_tp10_tile),
+	SDE_FORMAT_MAP_DESC(sde_format_map_ubwc),
+	SDE_FORMAT_MAP_DESC(sde_format_map_p010),
+	SDE_FORMAT_MAP_DESC(sde_format_map_p010_ubwc),
+	SDE_FORMAT_MAP_DESC(sde_format_map_tp10_ubwc),
+};
+
+/*
+ * Open addressed index of all format maps keyed on (map, fourcc), built
+ * once by sde_formats_init(). Lookups fall back to a linear scan of the
+ * map until the index is available.
+ */
+static const struct sde_format *sde_format_hash[SDE_FORMAT_HASH_SIZE];
+static bool sde_format_hash_valid;
+
+static inline u32 _sde_format_hash(const struct sde_format *map,
+		uint32_t format)
+{
+	return hash_32(format ^ hash_ptr((void *)map, 32),
+			SDE_FORMAT_HASH_BITS);
+}
+
+static inline bool _sde_format_in_map(const struct sde_format *fmt,
+		const struct sde_format *map, ssize_t map_size)
+{
+	return (fmt >= map) && (fmt < map + map_size);
+}
+
+void sde_formats_init(void)
+{
+	const struct sde_format *map, *fmt, *entry;
+	ssize_t map_size;
+	u32 i, j, slot;
+
+	if (sde_format_hash_valid)
+		return;
+
+	for (i = 0; i < ARRAY_SIZE(sde_format_maps); i++) {
+		map = sde_format_maps[i].map;
+		map_size = sde_format_maps[i].size;
+
+		for (j = 0; j < map_size; j++) {
+			fmt = &map[j];
+			slot = _sde_format_hash(map, fmt->base.pixel_format);
+
+			/* keep the first match of a map, as the linear scan does */
+			while ((entry = sde_format_hash[slot]) != NULL) {
+				if (_sde_format_in_map(entry, map, map_size) &&
+						entry->base.pixel_format ==
+						fmt->base.pixel_format)
+					break;
+				slot = (slot + 1) & (SDE_FORMAT_HASH_SIZE - 1);
+			}
+
+			if (!entry)
+				sde_format_hash[slot] = fmt;
+		}
+	}
+
+	sde_format_hash_valid = true;
+}
+
+static const struct sde_format *_sde_format_lookup(
+		const struct sde_format *map, ssize_t map_size,
+		const uint32_t format)
+{
+	const struct sde_format *entry;
+	u32 i, slot;
+
+	if (!sde_format_hash_valid) {
+		for (i = 0; i < map_size; i++) {
+			if (format == map[i].base.pixel_format)
+				return &map[i];
+		}
+		return NULL;
+	}
+
+	slot = _sde_format_hash(map, format);
+	while ((entry = sde_format_hash[slot]) != NULL) {
+		if (entry->base.pixel_format == format &&
+				_sde_format_in_map(entry, map, map_size))
+			return entry;
+		slot = (slot + 1) & (SDE_FORMAT_HASH_SIZE - 1);
+	}
+
+	return NULL;
+}
+
 const struct sde_format *sde_get_sde_format_ext(
 		const uint32_t format,
 		const uint64_t modifier)
 {
-	uint32_t i = 0;
 	const struct sde_format *fmt = NULL;
 	const struct sde_format *map = NULL;
 	ssize_t map_size = 0;
@@ -1259,12 +1382,7 @@ const struct sde_format *sde_get_sde_format_ext(
 		return NULL;
 	}
 
-	for (i = 0; i < map_size; i++) {
-		if (format == map[i].base.pixel_format) {
-			fmt = &map[i];
-			break;
-		}
-	}
+	fmt = _sde_format_lookup(map, map_size, format);
 
 	if (fmt == NULL)
 		SDE_DEBUG("unsupported fmt: %4.4s modifier 0x%llX\n",
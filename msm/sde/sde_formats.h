@@ -21,6 +21,12 @@ const struct sde_format *sde_get_sde_format_ext(
 
 #define sde_get_sde_format(f) sde_get_sde_format_ext(f, 0)
 
+/**
+ * sde_formats_init() - build the format lookup index used by
+ *                      sde_get_sde_format_ext(), safe to call more than once
+ */
+void sde_formats_init(void);
+
 /**
  * sde_get_msm_format - get an sde_format by its msm_format base
  *                     callback function registers with the msm_kms layer
@@ -87,6 +93,8 @@ int sde_format_check_modified_format(
  * @aspace:            address space pointer
  * @fb:                framebuffer pointer
  * @fmtl:              format layout structure to populate
+ * @cache_hit:         set if the plane sizes were reused from the layout
+ *                     cached in the fb, can be NULL
  *
  * Return: error code on failure, -EAGAIN if success but the addresses
  *         are the same as before or 0 if new addresses were populated
@@ -94,7 +102,8 @@ int sde_format_check_modified_format(
 int sde_format_populate_layout(
 		struct msm_gem_address_space *aspace,
 		struct drm_framebuffer *fb,
-		struct sde_hw_fmt_layout *fmtl);
+		struct sde_hw_fmt_layout *fmtl,
+		bool *cache_hit);
 
 /**
  * sde_format_get_framebuffer_size - get framebuffer memory size
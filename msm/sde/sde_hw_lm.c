@@ -400,6 +400,34 @@ static void _setup_mixer_ops(struct sde_mdss_cfg *m,
 		ops->setup_noise_layer = sde_hw_lm_setup_noise_layer;
 };
 
+/*
+ * Shadow the plain mixer and blend stage configuration registers, MISR and
+ * noise layer registers are left out.
+ */
+static int _sde_hw_lm_shadow_init(struct sde_hw_mixer *ctx)
+{
+	u32 regs[4 + 3 * MAX_BLOCKS];
+	u32 n = 0;
+	int stage, off;
+
+	regs[n++] = LM_OP_MODE;
+	regs[n++] = LM_OUT_SIZE;
+	regs[n++] = LM_BORDER_COLOR_0;
+	regs[n++] = LM_BORDER_COLOR_1;
+
+	for (stage = SDE_STAGE_0; stage - SDE_STAGE_0 < MAX_BLOCKS; stage++) {
+		off = _stage_offset(ctx, stage);
+		if (off < 0)
+			break;
+
+		regs[n++] = LM_BLEND0_OP + off;
+		regs[n++] = LM_BLEND0_FG_ALPHA + off;
+		regs[n++] = LM_BLEND0_BG_ALPHA + off;
+	}
+
+	return sde_reg_shadow_init(&ctx->hw, regs, n);
+}
+
 struct sde_hw_blk_reg_map *sde_hw_lm_init(enum sde_lm idx,
 		void __iomem *addr,
 		struct sde_mdss_cfg *m)
@@ -430,12 +458,18 @@ struct sde_hw_blk_reg_map *sde_hw_lm_init(enum sde_lm idx,
 	sde_dbg_reg_register_dump_range(SDE_DBG_NAME, cfg->name, c->hw.blk_off,
 			c->hw.blk_off + c->hw.length, c->hw.xin_id);
 
+	/* blend configuration is largely unchanged from frame to frame */
+	if (_sde_hw_lm_shadow_init(c))
+		SDE_DEBUG("lm %d register shadow unavailable\n", idx - LM_0);
+
 done:
 	return &c->hw;
 }
 
 void sde_hw_lm_destroy(struct sde_hw_blk_reg_map *hw)
 {
-	if (hw)
+	if (hw) {
+		sde_reg_shadow_deinit(hw);
 		kfree(to_sde_hw_mixer(hw));
+	}
 }
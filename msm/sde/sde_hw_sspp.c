@@ -1627,6 +1627,53 @@ static struct sde_sspp_cfg *_sspp_offset(enum sde_sspp sspp,
 	return ERR_PTR(-ENOMEM);
 }
 
+/*
+ * Plain source configuration registers, relative to the SRC sub-block.
+ * Triggers, status registers and everything REG DMA programs (scaler,
+ * LUTs and color processing) are left out of the register shadow.
+ */
+static const u32 sde_hw_sspp_shadow_regs[] = {
+	SSPP_SRC_SIZE,
+	SSPP_SRC_XY,
+	SSPP_OUT_SIZE,
+	SSPP_OUT_XY,
+	SSPP_SRC_YSTRIDE0,
+	SSPP_SRC_YSTRIDE1,
+	SSPP_SRC_FORMAT,
+	SSPP_SRC_UNPACK_PATTERN,
+	SSPP_SRC_OP_MODE,
+	SSPP_SRC_CONSTANT_COLOR,
+	SSPP_FETCH_CONFIG,
+	SSPP_DANGER_LUT,
+	SSPP_SAFE_LUT,
+	SSPP_CREQ_LUT,
+	SSPP_CREQ_LUT_0,
+	SSPP_CREQ_LUT_1,
+	SSPP_QOS_CTRL,
+	SSPP_SRC_SIZE_REC1,
+	SSPP_SRC_XY_REC1,
+	SSPP_OUT_SIZE_REC1,
+	SSPP_OUT_XY_REC1,
+	SSPP_SRC_FORMAT_REC1,
+	SSPP_SRC_UNPACK_PATTERN_REC1,
+	SSPP_SRC_OP_MODE_REC1,
+	SSPP_MULTIRECT_OPMODE,
+};
+
+static int _sde_hw_sspp_shadow_init(struct sde_hw_pipe *ctx)
+{
+	u32 regs[ARRAY_SIZE(sde_hw_sspp_shadow_regs)];
+	u32 i, idx;
+
+	if (_sspp_subblk_offset(ctx, SDE_SSPP_SRC, &idx))
+		return -EINVAL;
+
+	for (i = 0; i < ARRAY_SIZE(regs); i++)
+		regs[i] = sde_hw_sspp_shadow_regs[i] + idx;
+
+	return sde_reg_shadow_init(&ctx->hw, regs, ARRAY_SIZE(regs));
+}
+
 struct sde_hw_pipe *sde_hw_sspp_init(enum sde_sspp idx,
 		void __iomem *addr, struct sde_mdss_cfg *catalog,
 		bool is_virtual_pipe, struct sde_vbif_clk_client *clk_client)
@@ -1659,6 +1706,10 @@ struct sde_hw_pipe *sde_hw_sspp_init(enum sde_sspp idx,
 		sde_init_scaler_blk(&hw_pipe->cap->sblk->scaler_blk,
 			catalog->qseed_hw_rev);
 
+	/* virtual pipes share the shadow of the physical pipe */
+	if (_sde_hw_sspp_shadow_init(hw_pipe))
+		SDE_DEBUG("sspp %d register shadow unavailable\n", idx);
+
 	if (!is_virtual_pipe) {
 		sde_dbg_reg_register_dump_range(SDE_DBG_NAME, cfg->name,
 			hw_pipe->hw.blk_off,
@@ -1732,6 +1783,7 @@ void sde_hw_sspp_destroy(struct sde_hw_pipe *ctx)
 {
 	if (ctx) {
 		reg_dmav1_deinit_sspp_ops(ctx->idx);
+		sde_reg_shadow_deinit(&ctx->hw);
 		kfree(ctx->cap);
 	}
 	kfree(ctx);
@@ -13,6 +13,12 @@
 
 /* using a file static variables for debugfs access */
 static u32 sde_hw_util_log_mask = SDE_DBG_MASK_NONE;
+static bool sde_hw_util_reg_shadow_en;
+
+/* register shadows, shared between maps of the same block */
+static LIST_HEAD(sde_hw_reg_shadow_list);
+static DEFINE_MUTEX(sde_hw_reg_shadow_lock);
+static atomic_t sde_hw_reg_shadow_gen = ATOMIC_INIT(0);
 
 /* SDE_SCALER_QSEED3 */
 #define QSEED3_HW_VERSION                  0x00
@@ -71,6 +77,51 @@ static u32 sde_hw_util_log_mask = SDE_DBG_MASK_NONE;
 typedef void (*scaler_lut_type)(struct sde_hw_blk_reg_map *,
 		struct sde_hw_scaler3_cfg *, u32);
 
+static inline void _sde_reg_write(struct sde_hw_blk_reg_map *c,
+		u32 reg_off, u32 val)
+{
+	writel_relaxed(val, c->base_off + c->blk_off + reg_off);
+	SDE_REG_LOG(c->log_mask ? ilog2(c->log_mask)+1 : 0,
+			val, c->blk_off + reg_off);
+}
+
+/*
+ * Write a register through the shadow of its block. Returns false if the
+ * register is not shadowed and still has to be written by the caller.
+ */
+static bool _sde_reg_shadow_write(struct sde_hw_blk_reg_map *c,
+		u32 reg_off, u32 val)
+{
+	struct sde_hw_reg_shadow *shadow = c->shadow;
+	u32 idx = reg_off >> 2;
+	unsigned long flags;
+	u32 gen;
+
+	if ((reg_off & 0x3) || idx >= shadow->count ||
+			!test_bit(idx, shadow->allowed))
+		return false;
+
+	spin_lock_irqsave(&shadow->lock, flags);
+	gen = (u32)atomic_read(&sde_hw_reg_shadow_gen);
+	if (shadow->gen != gen) {
+		bitmap_zero(shadow->valid, shadow->count);
+		shadow->gen = gen;
+	}
+
+	if (sde_hw_util_reg_shadow_en && test_bit(idx, shadow->valid) &&
+			shadow->val[idx] == val) {
+		shadow->elided++;
+	} else {
+		_sde_reg_write(c, reg_off, val);
+		shadow->val[idx] = val;
+		__set_bit(idx, shadow->valid);
+		shadow->issued++;
+	}
+	spin_unlock_irqrestore(&shadow->lock, flags);
+
+	return true;
+}
+
 void sde_reg_write(struct sde_hw_blk_reg_map *c,
 		u32 reg_off,
 		u32 val,
@@ -80,14 +131,103 @@ void sde_reg_write(struct sde_hw_blk_reg_map *c,
 	if (c->log_mask & sde_hw_util_log_mask)
 		SDE_DEBUG_DRIVER("[%s:0x%X] <= 0x%X\n",
 				name, c->blk_off + reg_off, val);
-	writel_relaxed(val, c->base_off + c->blk_off + reg_off);
-	SDE_REG_LOG(c->log_mask ? ilog2(c->log_mask)+1 : 0,
-			val, c->blk_off + reg_off);
+
+	if (c->shadow && _sde_reg_shadow_write(c, reg_off, val))
+		return;
+
+	_sde_reg_write(c, reg_off, val);
 }
 
 int sde_reg_read(struct sde_hw_blk_reg_map *c, u32 reg_off)
 {
-	return readl_relaxed(c->base_off + c->blk_off + reg_off);
+	struct sde_hw_reg_shadow *shadow = c->shadow;
+	u32 idx = reg_off >> 2;
+	unsigned long flags;
+	u32 val;
+
+	if (!shadow || (reg_off & 0x3) || idx >= shadow->count ||
+			!test_bit(idx, shadow->allowed))
+		return readl_relaxed(c->base_off + c->blk_off + reg_off);
+
+	/* keep the shadow in sync with what the hardware reports */
+	spin_lock_irqsave(&shadow->lock, flags);
+	val = readl_relaxed(c->base_off + c->blk_off + reg_off);
+	if (shadow->gen == (u32)atomic_read(&sde_hw_reg_shadow_gen))
+		shadow->val[idx] = val;
+	spin_unlock_irqrestore(&shadow->lock, flags);
+
+	return val;
+}
+
+int sde_reg_shadow_init(struct sde_hw_blk_reg_map *c,
+		const u32 *regs, u32 num_regs)
+{
+	struct sde_hw_reg_shadow *shadow;
+	void __iomem *addr;
+	u32 count, i;
+	int rc = 0;
+
+	if (!c || !c->length || !regs || !num_regs)
+		return -EINVAL;
+
+	if (c->shadow)
+		return 0;
+
+	addr = c->base_off + c->blk_off;
+	count = c->length >> 2;
+
+	mutex_lock(&sde_hw_reg_shadow_lock);
+	list_for_each_entry(shadow, &sde_hw_reg_shadow_list, list) {
+		if (shadow->addr == addr && shadow->count == count) {
+			shadow->refcount++;
+			c->shadow = shadow;
+			goto exit;
+		}
+	}
+
+	shadow = kzalloc(sizeof(*shadow) + 2 * BITS_TO_LONGS(count) *
+			sizeof(unsigned long) + count * sizeof(u32), GFP_KERNEL);
+	if (!shadow) {
+		rc = -ENOMEM;
+		goto exit;
+	}
+
+	shadow->allowed = (unsigned long *)(shadow + 1);
+	shadow->valid = shadow->allowed + BITS_TO_LONGS(count);
+	shadow->val = (u32 *)(shadow->valid + BITS_TO_LONGS(count));
+	for (i = 0; i < num_regs; i++)
+		if (!(regs[i] & 0x3) && (regs[i] >> 2) < count)
+			__set_bit(regs[i] >> 2, shadow->allowed);
+	spin_lock_init(&shadow->lock);
+	shadow->addr = addr;
+	shadow->count = count;
+	shadow->gen = (u32)atomic_read(&sde_hw_reg_shadow_gen);
+	shadow->refcount = 1;
+	list_add_tail(&shadow->list, &sde_hw_reg_shadow_list);
+	c->shadow = shadow;
+exit:
+	mutex_unlock(&sde_hw_reg_shadow_lock);
+
+	return rc;
+}
+
+void sde_reg_shadow_deinit(struct sde_hw_blk_reg_map *c)
+{
+	if (!c || !c->shadow)
+		return;
+
+	mutex_lock(&sde_hw_reg_shadow_lock);
+	if (!--c->shadow->refcount) {
+		list_del(&c->shadow->list);
+		kfree(c->shadow);
+	}
+	c->shadow = NULL;
+	mutex_unlock(&sde_hw_reg_shadow_lock);
+}
+
+void sde_reg_shadow_invalidate_all(void)
+{
+	atomic_inc(&sde_hw_reg_shadow_gen);
 }
 
 u32 *sde_hw_util_get_log_mask_ptr(void)
@@ -95,6 +235,11 @@ u32 *sde_hw_util_get_log_mask_ptr(void)
 	return &sde_hw_util_log_mask;
 }
 
+bool *sde_hw_util_get_reg_shadow_en_ptr(void)
+{
+	return &sde_hw_util_reg_shadow_en;
+}
+
 void sde_init_scaler_blk(struct sde_scaler_blk *blk, u32 version)
 {
 	if (!blk)
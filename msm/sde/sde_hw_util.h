@@ -9,6 +9,7 @@
 
 #include <linux/io.h>
 #include <linux/slab.h>
+#include <linux/spinlock.h>
 #include "sde_hw_mdss.h"
 #include "sde_hw_catalog.h"
 
@@ -25,6 +26,38 @@ enum sde_ddr_type {
 
 struct sde_format_extended;
 
+/*
+ * Last value written to each shadowed 32-bit register of a block through
+ * sde_reg_write, used to elide writes which leave the register unchanged.
+ * Only registers on the allowlist given at init are shadowed; trigger,
+ * status and REG DMA programmed registers must not be listed. Shadows are
+ * shared by all register maps of the same block address.
+ * @list:         node in the global shadow list
+ * @refcount:     number of register maps using this shadow
+ * @lock:         serializes shadow updates with the register writes
+ * @addr:         mapped address of the block
+ * @count:        number of registers tracked
+ * @gen:          invalidation generation the cached values belong to
+ * @elided:       number of writes skipped
+ * @issued:       number of writes issued
+ * @allowed:      bitmap of registers which may be shadowed
+ * @valid:        bitmap of registers holding a cached value
+ * @val:          cached register values
+ */
+struct sde_hw_reg_shadow {
+	struct list_head list;
+	u32 refcount;
+	spinlock_t lock;
+	void __iomem *addr;
+	u32 count;
+	u32 gen;
+	u32 elided;
+	u32 issued;
+	unsigned long *allowed;
+	unsigned long *valid;
+	u32 *val;
+};
+
 /*
  * This is the common struct maintained by each sub block
  * for mapping the register offsets in this block to the
@@ -34,6 +67,7 @@ struct sde_format_extended;
  * @length        length of register block offset
  * @xin_id        xin id
  * @hw_rev     mdss hw revision
+ * @shadow:       optional register shadow, see sde_reg_shadow_init
  */
 struct sde_hw_blk_reg_map {
 	void __iomem *base_off;
@@ -42,6 +76,7 @@ struct sde_hw_blk_reg_map {
 	u32 xin_id;
 	u32 hw_rev;
 	u32 log_mask;
+	struct sde_hw_reg_shadow *shadow;
 };
 
 /**
@@ -191,12 +226,37 @@ struct sde_hw_inline_pre_downscale_cfg {
 
 u32 *sde_hw_util_get_log_mask_ptr(void);
 
+bool *sde_hw_util_get_reg_shadow_en_ptr(void);
+
 void sde_reg_write(struct sde_hw_blk_reg_map *c,
 		u32 reg_off,
 		u32 val,
 		const char *name);
 int sde_reg_read(struct sde_hw_blk_reg_map *c, u32 reg_off);
 
+/**
+ * sde_reg_shadow_init - attach a register shadow to a register block, the
+ *	shadow is shared with other maps of the same block
+ * @c: Pointer to register block map
+ * @regs: offsets of the plain configuration registers to shadow
+ * @num_regs: number of entries in @regs
+ * Returns: 0 on success or -ENOMEM
+ */
+int sde_reg_shadow_init(struct sde_hw_blk_reg_map *c,
+		const u32 *regs, u32 num_regs);
+
+/**
+ * sde_reg_shadow_deinit - detach the register shadow of a register block
+ * @c: Pointer to register block map
+ */
+void sde_reg_shadow_deinit(struct sde_hw_blk_reg_map *c);
+
+/**
+ * sde_reg_shadow_invalidate_all - drop the cached values of all register
+ *	shadows, to be called whenever registers may have been reset
+ */
+void sde_reg_shadow_invalidate_all(void);
+
 #define SDE_REG_WRITE(c, off, val) sde_reg_write(c, off, val, #off)
 #define SDE_REG_READ(c, off) sde_reg_read(c, off)
 
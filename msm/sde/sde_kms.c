@@ -166,6 +166,8 @@ static int _sde_debugfs_init(struct sde_kms *sde_kms)
 
 	/* allow debugfs_root to be NULL */
 	debugfs_create_x32(SDE_DEBUGFS_HWMASKNAME, 0600, debugfs_root, p);
+	debugfs_create_bool("reg_shadow", 0600, debugfs_root,
+			sde_hw_util_get_reg_shadow_en_ptr());
 
 	(void) sde_debugfs_vbif_init(sde_kms, debugfs_root);
 	(void) sde_debugfs_core_irq_init(sde_kms, debugfs_root);
@@ -3068,6 +3070,9 @@ static int _sde_kms_validate_vm_request(struct drm_atomic_state *state, struct s
 			return rc;
 		}
 
+		/* the other VM may have reprogrammed the hw meanwhile */
+		sde_reg_shadow_invalidate_all();
+
 		if (vm_ops->vm_resource_init)
 			rc = vm_ops->vm_resource_init(sde_kms, state);
 	}
@@ -4639,6 +4644,8 @@ static void sde_kms_handle_power_event(u32 event_type, void *usr)
 	SDE_EVT32_VERBOSE(event_type);
 
 	if (event_type == SDE_POWER_EVENT_POST_ENABLE) {
+		/* register contents are lost across power collapse */
+		sde_reg_shadow_invalidate_all();
 		sde_irq_update(msm_kms, true);
 		sde_kms->first_kickoff = true;
 
@@ -5327,6 +5334,7 @@ struct msm_kms *sde_kms_init(struct drm_device *dev)
 
 	dev_pm_opp_set_rate(dev->dev, max_freq);
 
+	sde_formats_init();
 	msm_kms_init(&sde_kms->base, &kms_funcs);
 	sde_kms->dev = dev;
 
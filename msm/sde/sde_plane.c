@@ -764,7 +764,7 @@ static inline void _sde_plane_set_scanout(struct drm_plane *plane,
 	struct sde_plane *psde;
 	struct msm_gem_address_space *aspace = NULL;
 	int ret, mode;
-	bool secure = false;
+	bool secure = false, cache_hit = false;
 
 	if (!plane || !pstate || !pipe_cfg || !fb) {
 		SDE_ERROR(
@@ -805,7 +805,15 @@ static inline void _sde_plane_set_scanout(struct drm_plane *plane,
 	if ((mode == SDE_DRM_FB_SEC) || (mode == SDE_DRM_FB_SEC_DIR_TRANS))
 		secure = true;
 
-	ret = sde_format_populate_layout(aspace, fb, &pipe_cfg->layout);
+	ret = sde_format_populate_layout(aspace, fb, &pipe_cfg->layout,
+			&cache_hit);
+	if (!ret || ret == -EAGAIN) {
+		if (cache_hit)
+			psde->layout_cache_hits++;
+		else
+			psde->layout_cache_misses++;
+	}
+
 	if (ret == -EAGAIN)
 		SDE_DEBUG_PLANE(psde, "not updating same src addrs\n");
 	else if (ret) {
@@ -2110,7 +2118,8 @@ static int sde_plane_prepare_fb(struct drm_plane *plane,
 	mode = sde_plane_get_property(pstate, PLANE_PROP_FB_TRANSLATION_MODE);
 	if (mode != SDE_DRM_FB_SEC_DIR_TRANS) {
 		/* validate framebuffer layout before commit */
-		ret = sde_format_populate_layout(pstate->aspace, fb, &layout);
+		ret = sde_format_populate_layout(pstate->aspace, fb, &layout,
+				NULL);
 		if (ret) {
 			SDE_ERROR_PLANE(psde, "failed to get format layout, %d\n", ret);
 			return ret;
@@ -4965,6 +4974,26 @@ static int _sde_plane_init_debugfs(struct drm_plane *plane)
 			psde->debugfs_root,
 			kms, &sde_plane_danger_enable);
 
+	debugfs_create_u32("layout_cache_hits",
+			0400,
+			psde->debugfs_root,
+			&psde->layout_cache_hits);
+	debugfs_create_u32("layout_cache_misses",
+			0400,
+			psde->debugfs_root,
+			&psde->layout_cache_misses);
+
+	if (psde->pipe_hw->hw.shadow) {
+		debugfs_create_u32("reg_shadow_issued",
+				0400,
+				psde->debugfs_root,
+				&psde->pipe_hw->hw.shadow->issued);
+		debugfs_create_u32("reg_shadow_elided",
+				0400,
+				psde->debugfs_root,
+				&psde->pipe_hw->hw.shadow->elided);
+	}
+
 	return 0;
 }
 
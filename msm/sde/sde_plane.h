@@ -98,6 +98,8 @@ struct sde_plane {
 	/* debugfs related stuff */
 	struct dentry *debugfs_root;
 	bool debugfs_default_scale;
+	u32 layout_cache_hits;
+	u32 layout_cache_misses;
 };
 
 #define to_sde_plane(x) container_of(x, struct sde_plane, base)
@@ -925,6 +925,40 @@ static int _sde_rm_debugfs_status_open(struct inode *inode,
 	return single_open(file, _sde_rm_status_show, inode->i_private);
 }
 
+static int _sde_rm_reg_shadow_show(struct seq_file *s, void *data)
+{
+	struct sde_rm *rm;
+	struct sde_rm_hw_blk *blk;
+	struct sde_hw_reg_shadow *shadow;
+	u32 type;
+
+	if (!s || !s->private)
+		return -EINVAL;
+
+	rm = s->private;
+	mutex_lock(&rm->rm_lock);
+	for (type = SDE_HW_BLK_LM; type < SDE_HW_BLK_MAX; type++) {
+		list_for_each_entry(blk, &rm->hw_blks[type], list) {
+			shadow = blk->hw ? blk->hw->shadow : NULL;
+			if (!shadow)
+				continue;
+
+			seq_printf(s, "blk:%s id:%d issued:%u elided:%u\n",
+				sde_hw_blk_str[type], blk->id,
+				shadow->issued, shadow->elided);
+		}
+	}
+	mutex_unlock(&rm->rm_lock);
+
+	return 0;
+}
+
+static int _sde_rm_debugfs_reg_shadow_open(struct inode *inode,
+		struct file *file)
+{
+	return single_open(file, _sde_rm_reg_shadow_show, inode->i_private);
+}
+
 void sde_rm_debugfs_init(struct sde_rm *sde_rm, struct dentry *parent)
 {
 	static const struct file_operations debugfs_rm_status_fops = {
@@ -932,7 +966,16 @@ void sde_rm_debugfs_init(struct sde_rm *sde_rm, struct dentry *parent)
 		.read =		seq_read,
 	};
 
+	static const struct file_operations debugfs_rm_reg_shadow_fops = {
+		.open =		_sde_rm_debugfs_reg_shadow_open,
+		.read =		seq_read,
+		.llseek =	seq_lseek,
+		.release =	single_release,
+	};
+
 	debugfs_create_file("rm_status", 0400, parent, sde_rm, &debugfs_rm_status_fops);
+	debugfs_create_file("rm_reg_shadow", 0400, parent, sde_rm,
+			&debugfs_rm_reg_shadow_fops);
 }
 #else
 void sde_rm_debugfs_init(struct sde_rm *rm, struct dentry *parent)
@@ -449,6 +449,31 @@ TRACE_EVENT(sde_hw_fence_status,
 			)
 );
 
+TRACE_EVENT(sde_dp_aux_xfer,
+	TP_PROTO(u32 request, u32 address, u32 size, int ret,
+		int aux_err, u32 latency_us),
+	TP_ARGS(request, address, size, ret, aux_err, latency_us),
+	TP_STRUCT__entry(
+			__field(u32, request)
+			__field(u32, address)
+			__field(u32, size)
+			__field(int, ret)
+			__field(int, aux_err)
+			__field(u32, latency_us)
+	),
+	TP_fast_assign(
+			__entry->request = request;
+			__entry->address = address;
+			__entry->size = size;
+			__entry->ret = ret;
+			__entry->aux_err = aux_err;
+			__entry->latency_us = latency_us;
+	),
+	TP_printk("req:0x%x addr:0x%x size:%u ret:%d aux_err:%d latency:%uus",
+			__entry->request, __entry->address, __entry->size,
+			__entry->ret, __entry->aux_err, __entry->latency_us)
+);
+
 #define sde_atrace trace_tracing_mark_write
 
 #define SDE_ATRACE_END(name) sde_atrace('E', current, name, 0)
@@ -17,6 +17,8 @@
 #include <linux/pm.h>
 #include <linux/pm_runtime.h>
 #include <linux/devcoredump.h>
+#include <linux/vmalloc.h>
+#include <linux/mm.h>
 
 #include "sde_dbg.h"
 #include "sde/sde_hw_catalog.h"
@@ -1566,9 +1568,7 @@ static int sde_dbg_debugfs_open(struct inode *inode, struct file *file)
 	file->private_data = inode->i_private;
 	mutex_lock(&sde_dbg_base.mutex);
 	sde_dbg_base.cur_evt_index = 0;
-	sde_dbg_base.evtlog->first = (u32)atomic_add_return(0, &sde_dbg_base.evtlog->curr) + 1;
-	atomic_set(&sde_dbg_base.evtlog->last,
-			(sde_dbg_base.evtlog->first + SDE_EVTLOG_ENTRY));
+	sde_evtlog_dump_rewind(sde_dbg_base.evtlog);
 	mutex_unlock(&sde_dbg_base.mutex);
 	return 0;
 }
@@ -1660,6 +1660,125 @@ static const struct file_operations sde_evtlog_fops = {
 	.write = sde_evtlog_dump_write,
 };
 
+/**
+ * struct sde_dbg_log_bin - binary log snapshot attached to an open file
+ * @buf: vmalloc_user snapshot buffer
+ * @size: snapshot size in bytes
+ */
+struct sde_dbg_log_bin {
+	void *buf;
+	size_t size;
+};
+
+static int _sde_dbg_log_bin_open(struct file *file, void *buf, size_t size)
+{
+	struct sde_dbg_log_bin *bin;
+
+	if (IS_ERR_OR_NULL(buf))
+		return buf ? PTR_ERR(buf) : -ENOMEM;
+
+	bin = kzalloc(sizeof(*bin), GFP_KERNEL);
+	if (!bin) {
+		vfree(buf);
+		return -ENOMEM;
+	}
+
+	bin->buf = buf;
+	bin->size = size;
+	file->private_data = bin;
+
+	return 0;
+}
+
+/*
+ * sde_evtlog_bin_open - debugfs open handler for binary evtlog export
+ * @inode: debugfs inode
+ * @file: file handle
+ */
+static int sde_evtlog_bin_open(struct inode *inode, struct file *file)
+{
+	size_t size = 0;
+	void *buf;
+
+	if (!inode || !file)
+		return -EINVAL;
+
+	buf = sde_evtlog_snapshot(sde_dbg_base.evtlog, &size);
+
+	return _sde_dbg_log_bin_open(file, buf, size);
+}
+
+/*
+ * sde_reglog_bin_open - debugfs open handler for binary reglog export
+ * @inode: debugfs inode
+ * @file: file handle
+ */
+static int sde_reglog_bin_open(struct inode *inode, struct file *file)
+{
+	size_t size = 0;
+	void *buf;
+
+	if (!inode || !file)
+		return -EINVAL;
+
+	buf = sde_reglog_snapshot(sde_dbg_base.reglog, &size);
+
+	return _sde_dbg_log_bin_open(file, buf, size);
+}
+
+static ssize_t sde_dbg_log_bin_read(struct file *file, char __user *buff,
+		size_t count, loff_t *ppos)
+{
+	struct sde_dbg_log_bin *bin = file->private_data;
+
+	return simple_read_from_buffer(buff, count, ppos, bin->buf, bin->size);
+}
+
+static int sde_dbg_log_bin_mmap(struct file *file, struct vm_area_struct *vma)
+{
+	struct sde_dbg_log_bin *bin = file->private_data;
+
+	/* snapshot is exported read-only */
+	if (vma->vm_flags & VM_WRITE)
+		return -EPERM;
+
+#if (LINUX_VERSION_CODE < KERNEL_VERSION(6, 1, 25))
+	vma->vm_flags &= ~VM_MAYWRITE;
+#else
+	vm_flags_clear(vma, VM_MAYWRITE);
+#endif
+
+	return remap_vmalloc_range(vma, bin->buf, vma->vm_pgoff);
+}
+
+static int sde_dbg_log_bin_release(struct inode *inode, struct file *file)
+{
+	struct sde_dbg_log_bin *bin = file->private_data;
+
+	if (bin) {
+		vfree(bin->buf);
+		kfree(bin);
+	}
+
+	return 0;
+}
+
+static const struct file_operations sde_evtlog_bin_fops = {
+	.open = sde_evtlog_bin_open,
+	.read = sde_dbg_log_bin_read,
+	.mmap = sde_dbg_log_bin_mmap,
+	.release = sde_dbg_log_bin_release,
+	.llseek = default_llseek,
+};
+
+static const struct file_operations sde_reglog_bin_fops = {
+	.open = sde_reglog_bin_open,
+	.read = sde_dbg_log_bin_read,
+	.mmap = sde_dbg_log_bin_mmap,
+	.release = sde_dbg_log_bin_release,
+	.llseek = default_llseek,
+};
+
 /**
  * sde_dbg_ctrl_read - debugfs read handler for debug ctrl read
  * @file: file handler
@@ -2525,6 +2644,8 @@ int sde_dbg_debugfs_register(struct device *dev)
 
 	debugfs_create_file("dbg_ctrl", 0600, debugfs_root, NULL, &sde_dbg_ctrl_fops);
 	debugfs_create_file("dump", 0600, debugfs_root, NULL, &sde_evtlog_fops);
+	debugfs_create_file("evtlog_bin", 0400, debugfs_root, NULL, &sde_evtlog_bin_fops);
+	debugfs_create_file("reglog_bin", 0400, debugfs_root, NULL, &sde_reglog_bin_fops);
 	debugfs_create_file("recovery_reg", 0400, debugfs_root, NULL, &sde_recovery_reg_fops);
 
 	debugfs_create_u32("enable", 0600, debugfs_root, &(sde_dbg_base.evtlog->enable));
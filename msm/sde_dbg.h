@@ -10,6 +10,7 @@
 #include <linux/stdarg.h>
 #include <linux/debugfs.h>
 #include <linux/list.h>
+#include <linux/seqlock.h>
 #if __has_include(<soc/qcom/minidump.h>)
 #include <soc/qcom/minidump.h>
 #else
@@ -142,6 +143,19 @@ enum sde_dbg_dump_context {
 #define SDE_EVTLOG_ENTRY	(SDE_EVTLOG_PRINT_ENTRY * 32)
 #endif /* IS_ENABLED(CONFIG_DRM_MSM_LOW_MEM_FOOTPRINT) */
 
+/*
+ * evtlog entries are spread over per-cpu rings so that concurrent loggers
+ * do not contend on a single index, the rings are merged by timestamp when
+ * the log is dumped. Each ring holds the full history depth, so logging
+ * concentrated on one cpu keeps as many entries as a single shared log.
+ */
+#define SDE_EVTLOG_RING_COUNT	8
+#define SDE_EVTLOG_RING_ENTRY	SDE_EVTLOG_ENTRY
+
+/* number of call sites remembered by the evtlog filter cache */
+#define SDE_EVTLOG_FILTER_CACHE_BITS	8
+#define SDE_EVTLOG_FILTER_CACHE_SIZE	BIT(SDE_EVTLOG_FILTER_CACHE_BITS)
+
 #define SDE_EVTLOG_MAX_DATA 15
 #define SDE_EVTLOG_BUF_MAX 512
 #define SDE_EVTLOG_BUF_ALIGN 32
@@ -163,22 +177,47 @@ struct sde_dbg_evtlog_log {
 };
 
 /**
+ * struct sde_dbg_evtlog_ring - ring of evtlog entries written by one cpu
+ * @curr: Number of entries logged into this ring
+ * @next: Index of next entry to be output during evtlog dumps
  * @last_dump: Index of last entry to be output during evtlog dumps
+ * @logs: Ring entries, indexed by entry index modulo SDE_EVTLOG_RING_ENTRY
+ */
+struct sde_dbg_evtlog_ring {
+	atomic_t curr ____cacheline_aligned_in_smp;
+	u32 next;
+	u32 last_dump;
+	struct sde_dbg_evtlog_log logs[SDE_EVTLOG_RING_ENTRY];
+};
+
+/**
+ * struct sde_evtlog_filter_cache - cached filter decision for a call site
+ * @name: Function name pointer of the call site
+ * @filtered: Whether entries from this call site are filtered out
+ */
+struct sde_evtlog_filter_cache {
+	const char *name;
+	bool filtered;
+};
+
+/**
+ * @rings: Per-cpu entry rings
+ * @last_time: Timestamp of the last entry output during evtlog dumps
  * @filter_list: Linked list of currently active filter strings
+ * @filter_seq: Sequence count protecting lockless filter cache lookups
+ * @filter_cache: Filter decisions of recently seen call sites
  */
 struct sde_dbg_evtlog {
-	struct sde_dbg_evtlog_log logs[SDE_EVTLOG_ENTRY];
-	u32 first;
-	atomic_t last;
-	u32 last_dump;
-	atomic_t curr;
-	u32 next;
+	struct sde_dbg_evtlog_ring rings[SDE_EVTLOG_RING_COUNT];
+	s64 last_time;
 	u32 enable;
 	u32 dump_mode;
 	char *dumped_evtlog;
 	u32 log_size;
 	spinlock_t spin_lock;
 	struct list_head filter_list;
+	seqcount_t filter_seq;
+	struct sde_evtlog_filter_cache filter_cache[SDE_EVTLOG_FILTER_CACHE_SIZE];
 };
 
 extern struct sde_dbg_evtlog *sde_dbg_base_evtlog;
@@ -376,6 +415,32 @@ ssize_t sde_evtlog_dump_to_buffer(struct sde_dbg_evtlog *evtlog,
  */
 u32 sde_evtlog_count(struct sde_dbg_evtlog *evtlog);
 
+/**
+ * sde_evtlog_snapshot - copy the evtlog entries held in memory into a
+ *	binary snapshot, see include/uapi/display/drm/sde_dbg_log.h
+ * @evtlog:	pointer to evtlog
+ * @size:	returns the snapshot size in bytes
+ * Returns:	vmalloc_user buffer to be released with vfree, or ERR_PTR
+ */
+void *sde_evtlog_snapshot(struct sde_dbg_evtlog *evtlog, size_t *size);
+
+/**
+ * sde_reglog_snapshot - copy the reglog entries held in memory into a
+ *	binary snapshot, see include/uapi/display/drm/sde_dbg_log.h
+ * @reglog:	pointer to reglog
+ * @size:	returns the snapshot size in bytes
+ * Returns:	vmalloc_user buffer to be released with vfree, or ERR_PTR
+ */
+void *sde_reglog_snapshot(struct sde_dbg_reglog *reglog, size_t *size);
+
+/**
+ * sde_evtlog_dump_rewind - restart evtlog dumps from the oldest entry
+ *	still held in memory
+ * @evtlog:	pointer to evtlog
+ * Returns:	none
+ */
+void sde_evtlog_dump_rewind(struct sde_dbg_evtlog *evtlog);
+
 /**
  * sde_evtlog_is_enabled - check whether log collection is enabled for given
  *	event log and log area flag
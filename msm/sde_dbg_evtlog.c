@@ -13,18 +13,37 @@
 #include <linux/uaccess.h>
 #include <linux/dma-buf.h>
 #include <linux/slab.h>
+#include <linux/hash.h>
+#include <linux/vmalloc.h>
 #include <linux/sched/clock.h>
+#include <drm/sde_dbg_log.h>
 
 #include "sde_dbg.h"
 #include "sde_trace.h"
 
 #define SDE_EVTLOG_FILTER_STRSIZE	64
 
+/* distinct function names tracked while building a binary snapshot */
+#define SDE_DBG_LOG_STRTAB_BITS		11
+#define SDE_DBG_LOG_STRTAB_SIZE		BIT(SDE_DBG_LOG_STRTAB_BITS)
+
 struct sde_evtlog_filter {
 	struct list_head list;
 	char filter[SDE_EVTLOG_FILTER_STRSIZE];
 };
 
+/**
+ * struct sde_dbg_log_strtab - string table built for a binary snapshot
+ * @name: Function name pointers, hashed by address
+ * @offset: String table offset of each name
+ * @size: Current string table size, offset 0 holds the empty string
+ */
+struct sde_dbg_log_strtab {
+	const char *name[SDE_DBG_LOG_STRTAB_SIZE];
+	u32 offset[SDE_DBG_LOG_STRTAB_SIZE];
+	u32 size;
+};
+
 static bool _sde_evtlog_is_filtered_no_lock(
 		struct sde_dbg_evtlog *evtlog, const char *str)
 {
@@ -51,6 +70,54 @@ static bool _sde_evtlog_is_filtered_no_lock(
 	return rc;
 }
 
+static void _sde_evtlog_filter_cache_reset(struct sde_dbg_evtlog *evtlog)
+{
+	write_seqcount_begin(&evtlog->filter_seq);
+	memset(evtlog->filter_cache, 0, sizeof(evtlog->filter_cache));
+	write_seqcount_end(&evtlog->filter_seq);
+}
+
+/*
+ * Call site names are __func__ strings with a stable address, so the
+ * result of matching a name against the filter list is cached per name
+ * pointer and only recomputed after the filter list changes.
+ */
+static bool _sde_evtlog_is_filtered(struct sde_dbg_evtlog *evtlog,
+		const char *str)
+{
+	struct sde_evtlog_filter_cache *entry;
+	unsigned long flags;
+	unsigned int seq;
+	bool hit, rc;
+
+	if (!str)
+		return true;
+
+	if (list_empty(&evtlog->filter_list))
+		return false;
+
+	entry = &evtlog->filter_cache[hash_ptr((void *)str,
+			SDE_EVTLOG_FILTER_CACHE_BITS)];
+	do {
+		seq = read_seqcount_begin(&evtlog->filter_seq);
+		hit = (entry->name == str);
+		rc = entry->filtered;
+	} while (read_seqcount_retry(&evtlog->filter_seq, seq));
+
+	if (hit)
+		return rc;
+
+	spin_lock_irqsave(&evtlog->spin_lock, flags);
+	rc = _sde_evtlog_is_filtered_no_lock(evtlog, str);
+	write_seqcount_begin(&evtlog->filter_seq);
+	entry->name = str;
+	entry->filtered = rc;
+	write_seqcount_end(&evtlog->filter_seq);
+	spin_unlock_irqrestore(&evtlog->spin_lock, flags);
+
+	return rc;
+}
+
 bool sde_evtlog_is_enabled(struct sde_dbg_evtlog *evtlog, u32 flag)
 {
 	return evtlog && (evtlog->enable & flag);
@@ -61,22 +128,31 @@ void sde_evtlog_log(struct sde_dbg_evtlog *evtlog, const char *name, int line,
 {
 	int i, val = 0;
 	va_list args;
+	struct sde_dbg_evtlog_ring *ring;
 	struct sde_dbg_evtlog_log *log;
-	u32 index;
+	u32 index, cpu;
 
 	if (!evtlog || !sde_evtlog_is_enabled(evtlog, flag) ||
-			_sde_evtlog_is_filtered_no_lock(evtlog, name))
+			_sde_evtlog_is_filtered(evtlog, name))
 		return;
 
-	index = abs(atomic_inc_return(&evtlog->curr) % SDE_EVTLOG_ENTRY);
+	/*
+	 * The ring is only shared with interrupts on the same cpu (or with
+	 * cpus aliasing to the same ring), the atomic reservation keeps the
+	 * index unique while leaving the cacheline local in the common case.
+	 */
+	cpu = raw_smp_processor_id();
+	ring = &evtlog->rings[cpu % SDE_EVTLOG_RING_COUNT];
+	index = (u32)(atomic_inc_return(&ring->curr) - 1) %
+			SDE_EVTLOG_RING_ENTRY;
 
-	log = &evtlog->logs[index];
+	log = &ring->logs[index];
 	log->time = local_clock();
 	log->name = name;
 	log->line = line;
 	log->data_cnt = 0;
 	log->pid = current->pid;
-	log->cpu = raw_smp_processor_id();
+	log->cpu = cpu;
 
 	va_start(args, flag);
 	for (i = 0; i < SDE_EVTLOG_MAX_DATA; i++) {
@@ -89,7 +165,6 @@ void sde_evtlog_log(struct sde_dbg_evtlog *evtlog, const char *name, int line,
 	}
 	va_end(args);
 	log->data_cnt = i;
-	atomic_inc_return(&evtlog->last);
 
 	trace_sde_evtlog(name, line, log->data_cnt, log->data);
 }
@@ -114,38 +189,103 @@ void sde_reglog_log(u8 blk_id, u32 val, u32 addr)
 	reglog->last++;
 }
 
+static inline struct sde_dbg_evtlog_log *_sde_evtlog_ring_entry(
+		struct sde_dbg_evtlog_ring *ring, u32 index)
+{
+	return &ring->logs[index % SDE_EVTLOG_RING_ENTRY];
+}
+
+/* find the ring holding the oldest entry which is not dumped yet */
+static struct sde_dbg_evtlog_ring *_sde_evtlog_dump_next_ring(
+		struct sde_dbg_evtlog *evtlog)
+{
+	struct sde_dbg_evtlog_ring *ring, *oldest = NULL;
+	struct sde_dbg_evtlog_log *log;
+	s64 time = 0;
+	int i;
+
+	for (i = 0; i < SDE_EVTLOG_RING_COUNT; i++) {
+		ring = &evtlog->rings[i];
+		if (ring->next == ring->last_dump)
+			continue;
+
+		log = _sde_evtlog_ring_entry(ring, ring->next);
+		if (!oldest || log->time < time) {
+			oldest = ring;
+			time = log->time;
+		}
+	}
+
+	return oldest;
+}
+
+/*
+ * Move the ring dump markers forward so that only the newest max_entries
+ * entries across all rings remain to be dumped.
+ */
+static void _sde_evtlog_dump_limit(struct sde_dbg_evtlog *evtlog,
+		u32 total, u32 max_entries)
+{
+	u32 first[SDE_EVTLOG_RING_COUNT];
+	struct sde_dbg_evtlog_ring *ring;
+	struct sde_dbg_evtlog_log *log;
+	s64 time;
+	int i, newest;
+	u32 n;
+
+	for (i = 0; i < SDE_EVTLOG_RING_COUNT; i++)
+		first[i] = evtlog->rings[i].last_dump;
+
+	for (n = 0; n < max_entries; n++) {
+		newest = 0;
+		time = S64_MIN;
+		for (i = 0; i < SDE_EVTLOG_RING_COUNT; i++) {
+			ring = &evtlog->rings[i];
+			if (first[i] == ring->next)
+				continue;
+
+			log = _sde_evtlog_ring_entry(ring, first[i] - 1);
+			if (log->time >= time) {
+				newest = i;
+				time = log->time;
+			}
+		}
+		first[newest]--;
+	}
+
+	pr_info("evtlog skipping %d entries\n", total - max_entries);
+
+	for (i = 0; i < SDE_EVTLOG_RING_COUNT; i++)
+		evtlog->rings[i].next = first[i];
+}
+
 /* always dump the last entries which are not dumped yet */
 static bool _sde_evtlog_dump_calc_range(struct sde_dbg_evtlog *evtlog,
 		bool update_last_entry, bool full_dump)
 {
-	int max_entries = full_dump ? SDE_EVTLOG_ENTRY : SDE_EVTLOG_PRINT_ENTRY;
+	u32 max_entries = full_dump ? SDE_EVTLOG_ENTRY : SDE_EVTLOG_PRINT_ENTRY;
+	struct sde_dbg_evtlog_ring *ring;
+	u32 total = 0;
+	int i;
 
 	if (!evtlog)
 		return false;
 
-	evtlog->first = evtlog->next;
-
-	if (update_last_entry)
-		evtlog->last_dump = (u32)atomic_read(&evtlog->last);
-
-	if (evtlog->last_dump == evtlog->first)
-		return false;
-
-	if (evtlog->last_dump < evtlog->first) {
-		evtlog->first %= SDE_EVTLOG_ENTRY;
-		if (evtlog->last_dump < evtlog->first)
-			evtlog->last_dump += SDE_EVTLOG_ENTRY;
-	}
+	if (update_last_entry) {
+		for (i = 0; i < SDE_EVTLOG_RING_COUNT; i++) {
+			ring = &evtlog->rings[i];
+			ring->last_dump = (u32)atomic_read(&ring->curr);
+			if ((ring->last_dump - ring->next) > SDE_EVTLOG_RING_ENTRY)
+				ring->next = ring->last_dump -
+						SDE_EVTLOG_RING_ENTRY;
+			total += ring->last_dump - ring->next;
+		}
 
-	if ((evtlog->last_dump - evtlog->first) > max_entries) {
-		pr_info("evtlog skipping %d entries, last=%d\n",
-			evtlog->last_dump - evtlog->first -
-			max_entries, evtlog->last_dump - 1);
-		evtlog->first = evtlog->last_dump - max_entries;
+		if (total > max_entries)
+			_sde_evtlog_dump_limit(evtlog, total, max_entries);
 	}
-	evtlog->next = evtlog->first + 1;
 
-	return true;
+	return _sde_evtlog_dump_next_ring(evtlog) != NULL;
 }
 
 ssize_t sde_evtlog_dump_to_buffer(struct sde_dbg_evtlog *evtlog,
@@ -154,8 +294,10 @@ ssize_t sde_evtlog_dump_to_buffer(struct sde_dbg_evtlog *evtlog,
 {
 	int i;
 	ssize_t off = 0;
-	struct sde_dbg_evtlog_log *log, *prev_log;
+	struct sde_dbg_evtlog_ring *ring;
+	struct sde_dbg_evtlog_log *log;
 	unsigned long flags;
+	u32 index;
 
 	if (!evtlog || !evtlog_buf)
 		return 0;
@@ -166,9 +308,12 @@ ssize_t sde_evtlog_dump_to_buffer(struct sde_dbg_evtlog *evtlog,
 	if (!_sde_evtlog_dump_calc_range(evtlog, update_last_entry, full_dump))
 		goto exit;
 
-	log = &evtlog->logs[evtlog->first % SDE_EVTLOG_ENTRY];
+	ring = _sde_evtlog_dump_next_ring(evtlog);
+	index = ring->next++;
+	log = _sde_evtlog_ring_entry(ring, index);
 
-	prev_log = &evtlog->logs[(evtlog->first - 1) % SDE_EVTLOG_ENTRY];
+	if (update_last_entry)
+		evtlog->last_time = log->time;
 
 	off = snprintf((evtlog_buf + off), (evtlog_buf_size - off), "%s:%-4d",
 		log->name, log->line);
@@ -179,8 +324,10 @@ ssize_t sde_evtlog_dump_to_buffer(struct sde_dbg_evtlog *evtlog,
 	}
 
 	off += snprintf((evtlog_buf + off), (evtlog_buf_size - off),
-		"=>[%-8d:%-11llu:%9llu][%-4d]:[%-4d]:", evtlog->first,
-		log->time, (log->time - prev_log->time), log->pid, log->cpu);
+		"=>[%d:%-8u:%-11llu:%9llu][%-4d]:[%-4d]:",
+		(int)(ring - evtlog->rings), index, log->time,
+		(log->time - evtlog->last_time), log->pid, log->cpu);
+	evtlog->last_time = log->time;
 
 	for (i = 0; i < log->data_cnt; i++)
 		off += snprintf((evtlog_buf + off), (evtlog_buf_size - off),
@@ -195,32 +342,192 @@ exit:
 
 u32 sde_evtlog_count(struct sde_dbg_evtlog *evtlog)
 {
-	u32 first, next, last, last_dump;
+	struct sde_dbg_evtlog_ring *ring;
+	u32 count = 0, pending;
+	int i;
 
 	if (!evtlog)
 		return 0;
 
-	first = evtlog->first;
-	next = evtlog->next;
-	last = (u32)atomic_read(&evtlog->last);
-	last_dump = evtlog->last_dump;
+	for (i = 0; i < SDE_EVTLOG_RING_COUNT; i++) {
+		ring = &evtlog->rings[i];
+		pending = (u32)atomic_read(&ring->curr) - ring->next;
+		count += min_t(u32, pending, SDE_EVTLOG_RING_ENTRY);
+	}
 
-	first = next;
-	last_dump = last;
+	return count;
+}
 
-	if (last_dump == first)
+void sde_evtlog_dump_rewind(struct sde_dbg_evtlog *evtlog)
+{
+	struct sde_dbg_evtlog_ring *ring;
+	unsigned long flags;
+	u32 curr;
+	int i;
+
+	if (!evtlog)
+		return;
+
+	spin_lock_irqsave(&evtlog->spin_lock, flags);
+	for (i = 0; i < SDE_EVTLOG_RING_COUNT; i++) {
+		ring = &evtlog->rings[i];
+		curr = (u32)atomic_read(&ring->curr);
+		ring->next = curr - min_t(u32, curr, SDE_EVTLOG_RING_ENTRY);
+		ring->last_dump = ring->next;
+	}
+	spin_unlock_irqrestore(&evtlog->spin_lock, flags);
+}
+
+static u32 _sde_dbg_log_strtab_add(struct sde_dbg_log_strtab *strtab,
+		const char *name)
+{
+	u32 slot, i;
+
+	if (!name)
 		return 0;
 
-	if (last_dump < first) {
-		first %= SDE_EVTLOG_ENTRY;
-		if (last_dump < first)
-			last_dump += SDE_EVTLOG_ENTRY;
+	slot = hash_ptr((void *)name, SDE_DBG_LOG_STRTAB_BITS);
+	for (i = 0; i < SDE_DBG_LOG_STRTAB_SIZE; i++) {
+		if (strtab->name[slot] == name)
+			return strtab->offset[slot];
+
+		if (!strtab->name[slot]) {
+			strtab->name[slot] = name;
+			strtab->offset[slot] = strtab->size;
+			strtab->size += strlen(name) + 1;
+			return strtab->offset[slot];
+		}
+
+		slot = (slot + 1) & (SDE_DBG_LOG_STRTAB_SIZE - 1);
+	}
+
+	/* table full, the record is exported without a name */
+	return 0;
+}
+
+static void *_sde_dbg_log_snapshot_build(u32 type, const void *records,
+		u32 record_size, u32 record_count,
+		struct sde_dbg_log_strtab *strtab, size_t *size)
+{
+	struct sde_dbg_log_header *hdr;
+	u32 strtab_size = strtab ? strtab->size : 1;
+	size_t records_size = (size_t)record_size * record_count;
+	char *buf;
+	int i;
+
+	*size = sizeof(*hdr) + records_size + strtab_size;
+	buf = vmalloc_user(PAGE_ALIGN(*size));
+	if (!buf)
+		return ERR_PTR(-ENOMEM);
+
+	hdr = (struct sde_dbg_log_header *)buf;
+	hdr->magic = SDE_DBG_LOG_MAGIC;
+	hdr->version = SDE_DBG_LOG_VERSION;
+	hdr->type = type;
+	hdr->record_size = record_size;
+	hdr->record_count = record_count;
+	hdr->record_offset = sizeof(*hdr);
+	hdr->strtab_offset = sizeof(*hdr) + records_size;
+	hdr->strtab_size = strtab_size;
+
+	memcpy(buf + hdr->record_offset, records, records_size);
+
+	for (i = 0; strtab && i < SDE_DBG_LOG_STRTAB_SIZE; i++)
+		if (strtab->name[i])
+			memcpy(buf + hdr->strtab_offset + strtab->offset[i],
+				strtab->name[i], strlen(strtab->name[i]) + 1);
+
+	return buf;
+}
+
+void *sde_evtlog_snapshot(struct sde_dbg_evtlog *evtlog, size_t *size)
+{
+	struct sde_dbg_evtlog_record *records, *rec;
+	struct sde_dbg_log_strtab *strtab;
+	struct sde_dbg_evtlog_ring *ring;
+	struct sde_dbg_evtlog_log *log;
+	u32 count = 0, curr, index;
+	void *buf;
+	int i;
+
+	if (!evtlog || !size)
+		return ERR_PTR(-EINVAL);
+
+	records = kvcalloc(SDE_EVTLOG_RING_COUNT * SDE_EVTLOG_RING_ENTRY,
+			sizeof(*records), GFP_KERNEL);
+	strtab = kzalloc(sizeof(*strtab), GFP_KERNEL);
+	if (!records || !strtab) {
+		buf = ERR_PTR(-ENOMEM);
+		goto exit;
+	}
+	strtab->size = 1;
+
+	/* entries are copied without locking, same as the text dump */
+	for (i = 0; i < SDE_EVTLOG_RING_COUNT; i++) {
+		ring = &evtlog->rings[i];
+		curr = (u32)atomic_read(&ring->curr);
+		index = curr - min_t(u32, curr, SDE_EVTLOG_RING_ENTRY);
+
+		for (; index != curr; index++) {
+			log = &ring->logs[index % SDE_EVTLOG_RING_ENTRY];
+			rec = &records[count++];
+			rec->time = log->time;
+			rec->name_offset = _sde_dbg_log_strtab_add(strtab,
+					log->name);
+			rec->line = log->line;
+			rec->pid = log->pid;
+			rec->cpu = log->cpu;
+			rec->index = index;
+			rec->data_cnt = min_t(u32, log->data_cnt,
+					SDE_EVTLOG_MAX_DATA);
+			memcpy(rec->data, log->data,
+					rec->data_cnt * sizeof(rec->data[0]));
+		}
+	}
+
+	buf = _sde_dbg_log_snapshot_build(SDE_DBG_LOG_TYPE_EVTLOG, records,
+			sizeof(*records), count, strtab, size);
+exit:
+	kfree(strtab);
+	kvfree(records);
+
+	return buf;
+}
+
+void *sde_reglog_snapshot(struct sde_dbg_reglog *reglog, size_t *size)
+{
+	struct sde_dbg_reglog_record *records, *rec;
+	struct sde_dbg_reglog_log *log;
+	u64 curr, index;
+	u32 count = 0;
+	void *buf;
+
+	if (!reglog || !size)
+		return ERR_PTR(-EINVAL);
+
+	records = kvcalloc(SDE_REGLOG_ENTRY, sizeof(*records), GFP_KERNEL);
+	if (!records)
+		return ERR_PTR(-ENOMEM);
+
+	/* sde_reglog_log stores entry n at index n % SDE_REGLOG_ENTRY */
+	curr = (u64)atomic64_read(&reglog->curr);
+	index = curr - min_t(u64, curr, SDE_REGLOG_ENTRY) + 1;
+
+	for (; index <= curr; index++) {
+		log = &reglog->logs[index % SDE_REGLOG_ENTRY];
+		rec = &records[count++];
+		rec->time = log->time;
+		rec->pid = log->pid;
+		rec->addr = log->addr;
+		rec->val = log->val;
+		rec->blk_id = log->blk_id;
 	}
 
-	if ((last_dump - first) > SDE_EVTLOG_ENTRY)
-		return SDE_EVTLOG_ENTRY;
+	buf = _sde_dbg_log_snapshot_build(SDE_DBG_LOG_TYPE_REGLOG, records,
+			sizeof(*records), count, NULL, size);
+	kvfree(records);
 
-	return last_dump - first;
+	return buf;
 }
 
 struct sde_dbg_evtlog *sde_evtlog_init(void)
@@ -232,7 +539,7 @@ struct sde_dbg_evtlog *sde_evtlog_init(void)
 		return ERR_PTR(-ENOMEM);
 
 	spin_lock_init(&evtlog->spin_lock);
-	atomic_set(&evtlog->curr, 0);
+	seqcount_init(&evtlog->filter_seq);
 	evtlog->enable = SDE_EVTLOG_DEFAULT_ENABLE;
 	evtlog->dump_mode = SDE_DBG_DEFAULT_DUMP_MODE;
 
@@ -305,6 +612,7 @@ void sde_evtlog_set_filter(struct sde_dbg_evtlog *evtlog, char *filter)
 		list_del_init(&filter_node->list);
 		list_add_tail(&filter_node->list, &free_list);
 	}
+	_sde_evtlog_filter_cache_reset(evtlog);
 	spin_unlock_irqrestore(&evtlog->spin_lock, flags);
 
 	/*
@@ -335,6 +643,7 @@ void sde_evtlog_set_filter(struct sde_dbg_evtlog *evtlog, char *filter)
 
 		spin_lock_irqsave(&evtlog->spin_lock, flags);
 		list_add_tail(&filter_node->list, &evtlog->filter_list);
+		_sde_evtlog_filter_cache_reset(evtlog);
 		spin_unlock_irqrestore(&evtlog->spin_lock, flags);
 	}
 
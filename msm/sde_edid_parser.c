@@ -71,56 +71,93 @@ sde_cea_revision(const u8 *cea)
 	return cea[1];
 }
 
-static int
-sde_cea_db_offsets(const u8 *cea, int *start, int *end)
+static u32 sde_edid_size(const struct edid *edid)
 {
-	/* Data block offset in CEA extension block */
-	*start = 4;
-	*end = cea[2];
-	if (*end == 0)
-		*end = 127;
-	if (*end < 4 || *end > 127)
-		return -ERANGE;
-	return 0;
+	return (edid->extensions + 1) * EDID_LENGTH;
 }
 
-#define sde_for_each_cea_db(cea, i, start, end) \
-for ((i) = (start); \
-(i) < (end) && (i) + sde_cea_db_payload_len(&(cea)[(i)]) < (end); \
-(i) += sde_cea_db_payload_len(&(cea)[(i)]) + 1)
-
-static const u8 *_sde_edid_find_block(const u8 *in_buf, u32 start_offset,
-	u8 type, u8 *len)
+/*
+ * sde_edid_index_cea_db - Index the CEA data block collection
+ * @edid_ctrl: handle to the edid_ctrl structure
+ *
+ * Walks the CEA data block collection once and records the offset, tag and
+ * extended tag of every block, so the individual block parsers look them up
+ * instead of rescanning the extension.
+ */
+static void sde_edid_index_cea_db(struct sde_edid_ctrl *edid_ctrl)
 {
-	/* the start of data block collection, start of Video Data Block */
-	u32 offset = start_offset;
-	u32 dbc_offset = in_buf[2];
+	struct sde_edid_cea_db *entry;
+	const u8 *cea;
+	u32 offset, end;
+	u8 len;
+
+	edid_ctrl->cea_offset = 0;
+	edid_ctrl->cea_rev = 0;
+	edid_ctrl->cea_db_cnt = 0;
+	edid_ctrl->cea_db_tags = 0;
+
+	cea = sde_find_cea_extension(edid_ctrl->edid);
+	if (!cea) {
+		SDE_DEBUG("CEA extension not found\n");
+		return;
+	}
+
+	edid_ctrl->cea_offset = cea - (u8 *)edid_ctrl->edid;
+	edid_ctrl->cea_rev = sde_cea_revision(cea);
 
-	SDE_EDID_DEBUG("%s +", __func__);
 	/*
-	 * * edid buffer 1, byte 2 being 4 means no non-DTD/Data block
-	 *   collection present.
-	 * * edid buffer 1, byte 2 being 0 means no non-DTD/DATA block
-	 *   collection present and no DTD data present.
+	 * byte 2 being 0 or 4 means no data block collection present,
+	 * otherwise it is the offset of the first DTD.
 	 */
+	end = cea[2];
+	if (end <= DBC_START_OFFSET || end > 127) {
+		SDE_EDID_DEBUG("EDID: no data block collection present\n");
+		return;
+	}
 
-	if ((dbc_offset == 0) || (dbc_offset == 4)) {
-		SDE_EDID_DEBUG("EDID: no DTD or non-DTD data present\n");
-		return NULL;
+	for (offset = DBC_START_OFFSET; offset < end; offset += len + 1) {
+		len = sde_cea_db_payload_len(&cea[offset]);
+		if (offset + len >= end)
+			break;
+
+		if (edid_ctrl->cea_db_cnt >= SDE_EDID_MAX_CEA_DB) {
+			SDE_DEBUG("too many CEA data blocks, ignore rest\n");
+			break;
+		}
+
+		entry = &edid_ctrl->cea_db[edid_ctrl->cea_db_cnt++];
+		entry->offset = offset;
+		entry->tag = sde_cea_db_tag(&cea[offset]);
+		entry->ext_tag = (entry->tag == USE_EXTENDED_TAG && len) ?
+				cea[offset + 1] : 0;
+		edid_ctrl->cea_db_tags |= BIT(entry->tag);
+
+		SDE_EDID_DEBUG("block=%d ext=%d found @ 0x%x w/ len=%d\n",
+			entry->tag, entry->ext_tag, offset, len);
 	}
+}
 
-	while (offset < dbc_offset) {
-		u8 block_len = in_buf[offset] & 0x1F;
+/*
+ * sde_edid_find_cea_db - Find the next indexed CEA data block of a tag
+ * @edid_ctrl: handle to the edid_ctrl structure
+ * @tag: data block tag code
+ * @idx: index to start searching from, advanced past the returned block
+ *
+ * Return: pointer to the data block header or NULL if none is left.
+ */
+static const u8 *sde_edid_find_cea_db(struct sde_edid_ctrl *edid_ctrl,
+	u8 tag, u32 *idx)
+{
+	struct sde_edid_cea_db *entry;
 
-		if ((offset + block_len <= dbc_offset) &&
-		    (in_buf[offset] >> 5) == type) {
-			*len = block_len;
-			SDE_EDID_DEBUG("block=%d found @ 0x%x w/ len=%d\n",
-				type, offset, block_len);
+	if (!(edid_ctrl->cea_db_tags & BIT(tag)))
+		return NULL;
 
-			return in_buf + offset;
-		}
-		offset += 1 + block_len;
+	while (*idx < edid_ctrl->cea_db_cnt) {
+		entry = &edid_ctrl->cea_db[(*idx)++];
+		if (entry->tag == tag)
+			return (u8 *)edid_ctrl->edid + edid_ctrl->cea_offset +
+					entry->offset;
 	}
 
 	return NULL;
@@ -155,47 +192,38 @@ static void _sde_edid_extract_audio_data_blocks(
 	u8 len = 0;
 	u8 adb_max = 0;
 	const u8 *adb = NULL;
-	u32 offset = DBC_START_OFFSET;
-	u8 *cea = NULL;
+	u32 idx = 0;
 
 	if (!edid_ctrl) {
 		SDE_ERROR("invalid edid_ctrl\n");
 		return;
 	}
 	SDE_EDID_DEBUG("%s +", __func__);
-	cea = sde_find_cea_extension(edid_ctrl->edid);
-	if (!cea) {
-		SDE_DEBUG("CEA extension not found\n");
-		return;
-	}
 
 	edid_ctrl->adb_size = 0;
 
 	memset(edid_ctrl->audio_data_block, 0,
 		sizeof(edid_ctrl->audio_data_block));
 
-	do {
-		len = 0;
-		adb = _sde_edid_find_block(cea, offset, AUDIO_DATA_BLOCK,
-			&len);
-
-		if ((adb == NULL) || (len > MAX_AUDIO_DATA_BLOCK_SIZE ||
-			adb_max >= MAX_NUMBER_ADB)) {
-			if (!edid_ctrl->adb_size) {
-				SDE_DEBUG("No/Invalid Audio Data Block\n");
-				return;
-			}
+	while (adb_max < MAX_NUMBER_ADB) {
+		adb = sde_edid_find_cea_db(edid_ctrl, AUDIO_DATA_BLOCK, &idx);
+		if (!adb)
+			break;
 
+		len = sde_cea_db_payload_len(adb);
+		if (len > MAX_AUDIO_DATA_BLOCK_SIZE)
 			continue;
-		}
 
 		memcpy(edid_ctrl->audio_data_block + edid_ctrl->adb_size,
 			adb + 1, len);
-		offset = (adb - cea) + 1 + len;
 
 		edid_ctrl->adb_size += len;
 		adb_max++;
-	} while (adb);
+	}
+
+	if (!edid_ctrl->adb_size)
+		SDE_DEBUG("No/Invalid Audio Data Block\n");
+
 	SDE_EDID_DEBUG("%s -", __func__);
 }
 
@@ -337,43 +365,34 @@ sde_parse_clrmetry_db(struct drm_connector *connector, const u8 *db)
 /*
  * sde_edid_parse_extended_blk_info - Parse the HDMI extended tag blocks
  * @connector: connector corresponding to external sink
- * @edid: handle to the EDID structure
+ * @edid_ctrl: handle to the edid_ctrl structure
  * Parses the all extended tag blocks extract sink info for @connector.
  */
 static void
 sde_edid_parse_extended_blk_info(struct drm_connector *connector,
-	struct edid *edid)
+	struct sde_edid_ctrl *edid_ctrl)
 {
-	const u8 *cea = sde_find_cea_extension(edid);
 	const u8 *db = NULL;
+	u32 idx = 0;
 
-	if (cea && sde_cea_revision(cea) >= 3) {
-		int i, start, end;
-
-		if (sde_cea_db_offsets(cea, &start, &end))
-			return;
-
-		sde_for_each_cea_db(cea, i, start, end) {
-			db = &cea[i];
-
-			if (sde_cea_db_tag(db) == USE_EXTENDED_TAG) {
-				SDE_EDID_DEBUG("found ext tag block = %d\n",
-						db[1]);
-				switch (db[1]) {
-				case VENDOR_SPECIFIC_VIDEO_DATA_BLOCK:
-					sde_edid_parse_vsvdb_info(connector,
-							db);
-					break;
-				case HDR_STATIC_METADATA_DATA_BLOCK:
-					sde_edid_parse_hdr_db(connector, db);
-					break;
-				case COLORIMETRY_EXTENDED_DATA_BLOCK:
-					sde_parse_clrmetry_db(connector, db);
-					break;
-				default:
-					break;
-				}
-			}
+	if (edid_ctrl->cea_rev < 3)
+		return;
+
+	while ((db = sde_edid_find_cea_db(edid_ctrl, USE_EXTENDED_TAG,
+			&idx))) {
+		SDE_EDID_DEBUG("found ext tag block = %d\n", db[1]);
+		switch (db[1]) {
+		case VENDOR_SPECIFIC_VIDEO_DATA_BLOCK:
+			sde_edid_parse_vsvdb_info(connector, db);
+			break;
+		case HDR_STATIC_METADATA_DATA_BLOCK:
+			sde_edid_parse_hdr_db(connector, db);
+			break;
+		case COLORIMETRY_EXTENDED_DATA_BLOCK:
+			sde_parse_clrmetry_db(connector, db);
+			break;
+		default:
+			break;
 		}
 	}
 }
@@ -381,23 +400,23 @@ sde_edid_parse_extended_blk_info(struct drm_connector *connector,
 static void _sde_edid_extract_speaker_allocation_data(
 	struct sde_edid_ctrl *edid_ctrl)
 {
-	u8 len;
+	u8 len = 0;
 	const u8 *sadb = NULL;
-	u8 *cea = NULL;
+	u32 idx = 0;
 
 	if (!edid_ctrl) {
 		SDE_ERROR("invalid edid_ctrl\n");
 		return;
 	}
 	SDE_EDID_DEBUG("%s +", __func__);
-	cea = sde_find_cea_extension(edid_ctrl->edid);
-	if (!cea) {
-		SDE_DEBUG("CEA extension not found\n");
-		return;
-	}
 
-	sadb = _sde_edid_find_block(cea, DBC_START_OFFSET,
-		SPEAKER_ALLOCATION_DATA_BLOCK, &len);
+	edid_ctrl->sadb_size = 0;
+
+	sadb = sde_edid_find_cea_db(edid_ctrl,
+		SPEAKER_ALLOCATION_DATA_BLOCK, &idx);
+	if (sadb)
+		len = sde_cea_db_payload_len(sadb);
+
 	if ((sadb == NULL) || (len != MAX_SPKR_ALLOC_DATA_BLOCK_SIZE)) {
 		SDE_DEBUG("No/Invalid Speaker Allocation Data Block\n");
 		return;
@@ -448,6 +467,7 @@ void sde_edid_deinit(void **input)
 
 	SDE_EDID_DEBUG("%s +", __func__);
 	sde_free_edid((void *)&edid_ctrl);
+	kfree(edid_ctrl->parsed_edid);
 	kfree(edid_ctrl);
 	SDE_EDID_DEBUG("%s -", __func__);
 }
@@ -464,8 +484,7 @@ int _sde_edid_update_modes(struct drm_connector *connector,
 			edid_ctrl->edid);
 
 		rc = drm_add_edid_modes(connector, edid_ctrl->edid);
-		sde_edid_parse_extended_blk_info(connector,
-				edid_ctrl->edid);
+		sde_edid_parse_extended_blk_info(connector, edid_ctrl);
 		SDE_EDID_DEBUG("%s -", __func__);
 		return rc;
 	}
@@ -506,6 +525,33 @@ bool sde_detect_hdmi_monitor(void *input)
 	return drm_detect_hdmi_monitor(edid_ctrl->edid);
 }
 
+/*
+ * The parsed state is kept across sde_free_edid(), so a reprobe of the
+ * same sink only needs to compare the EDID against the last parsed copy.
+ */
+static bool sde_edid_is_parsed(struct sde_edid_ctrl *edid_ctrl)
+{
+	u32 size = sde_edid_size(edid_ctrl->edid);
+
+	if (!edid_ctrl->parsed_edid || edid_ctrl->parsed_size != size)
+		return false;
+
+	if (edid_ctrl->parsed_edid[size - 1] !=
+			sde_get_edid_checksum(edid_ctrl))
+		return false;
+
+	return !memcmp(edid_ctrl->parsed_edid, edid_ctrl->edid, size);
+}
+
+static void sde_edid_save_parsed(struct sde_edid_ctrl *edid_ctrl)
+{
+	u32 size = sde_edid_size(edid_ctrl->edid);
+
+	kfree(edid_ctrl->parsed_edid);
+	edid_ctrl->parsed_edid = kmemdup(edid_ctrl->edid, size, GFP_KERNEL);
+	edid_ctrl->parsed_size = edid_ctrl->parsed_edid ? size : 0;
+}
+
 void sde_parse_edid(void *input)
 {
 	struct sde_edid_ctrl *edid_ctrl;
@@ -517,13 +563,21 @@ void sde_parse_edid(void *input)
 
 	edid_ctrl = (struct sde_edid_ctrl *)(input);
 
-	if (edid_ctrl->edid) {
-		sde_edid_extract_vendor_id(edid_ctrl);
-		_sde_edid_extract_audio_data_blocks(edid_ctrl);
-		_sde_edid_extract_speaker_allocation_data(edid_ctrl);
-	} else {
+	if (!edid_ctrl->edid) {
 		SDE_ERROR("edid not present\n");
+		return;
 	}
+
+	if (sde_edid_is_parsed(edid_ctrl)) {
+		SDE_EDID_DEBUG("EDID unchanged, skip parsing\n");
+		return;
+	}
+
+	sde_edid_extract_vendor_id(edid_ctrl);
+	sde_edid_index_cea_db(edid_ctrl);
+	_sde_edid_extract_audio_data_blocks(edid_ctrl);
+	_sde_edid_extract_speaker_allocation_data(edid_ctrl);
+	sde_edid_save_parsed(edid_ctrl);
 }
 
 void sde_get_edid(struct drm_connector *connector,
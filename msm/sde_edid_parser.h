@@ -23,6 +23,8 @@
 #define SDE_CEA_EXT    0x02
 #define SDE_EXTENDED_TAG 0x07
 
+#define SDE_EDID_MAX_CEA_DB 32
+
 #define SDE_DRM_MODE_FLAG_FMT_MASK (0x3 << 20)
 
 #define VSVDB_HDR10_PLUS_IEEE_CODE 0x90848b
@@ -81,6 +83,18 @@ struct sde_edid_sink_caps {
 	bool ind_view_support;
 };
 
+/*
+ * struct sde_edid_cea_db - CEA data block index entry
+ * @offset: offset of the block header within the CEA extension
+ * @tag: data block tag code
+ * @ext_tag: extended tag code, valid if @tag is SDE_EXTENDED_TAG
+ */
+struct sde_edid_cea_db {
+	u8 offset;
+	u8 tag;
+	u8 ext_tag;
+};
+
 struct sde_edid_ctrl {
 	struct edid *edid;
 	u8 pt_scan_info;
@@ -94,6 +108,17 @@ struct sde_edid_ctrl {
 	char vendor_id[EDID_VENDOR_ID_SIZE];
 	struct sde_edid_sink_caps sink_caps;
 	struct sde_edid_hdr_data hdr_data;
+
+	/* CEA data block index of the last parsed EDID */
+	u32 cea_offset;
+	u8 cea_rev;
+	u8 cea_db_tags;
+	u8 cea_db_cnt;
+	struct sde_edid_cea_db cea_db[SDE_EDID_MAX_CEA_DB];
+
+	/* copy of the last parsed EDID, used to skip reparsing on reprobe */
+	u8 *parsed_edid;
+	u32 parsed_size;
 };
 
 /**
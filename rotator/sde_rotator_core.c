@@ -30,6 +30,7 @@
 #include "sde_rotator_smmu.h"
 #include "sde_rotator_r1.h"
 #include "sde_rotator_r3.h"
+#include "sde_rotator_sw.h"
 #include "sde_rotator_trace.h"
 #include "sde_rotator_debug.h"
 
@@ -166,7 +167,9 @@ static int sde_rotator_enable_reg_bus(struct sde_rot_mgr *mgr, u64 quota)
 /*
  * Clock rate of all open sessions working a particular hw block
  * are added together to get the required rate for that hw block.
- * The max of each hw block becomes the final clock rate voted for
+ * The max of each hw block becomes the final clock rate voted for.
+ * With multi_queue all queues feed the same rotator core, so every
+ * session is accounted once against that single block.
  */
 static unsigned long sde_rotator_clk_rate_calc(
 	struct sde_rot_mgr *mgr,
@@ -185,8 +188,10 @@ static unsigned long sde_rotator_clk_rate_calc(
 		 */
 		for (i = 0; i < mgr->queue_count; i++) {
 			if (perf->work_distribution[i]) {
-				clk_rate[i] += perf->clk_rate;
 				rate_accounted_for = true;
+				if (mgr->multi_queue)
+					break;
+				clk_rate[i] += perf->clk_rate;
 			}
 		}
 
@@ -196,9 +201,14 @@ static unsigned long sde_rotator_clk_rate_calc(
 		 * wb idx.
 		 */
 		wb_idx = perf->last_wb_idx;
-		if ((!rate_accounted_for) && (wb_idx >= 0) &&
-				(wb_idx < mgr->queue_count))
+		if (mgr->multi_queue) {
+			if (rate_accounted_for || ((wb_idx >= 0) &&
+					(wb_idx < mgr->queue_count)))
+				clk_rate[0] += perf->clk_rate;
+		} else if ((!rate_accounted_for) && (wb_idx >= 0) &&
+				(wb_idx < mgr->queue_count)) {
 			clk_rate[wb_idx] += perf->clk_rate;
+		}
 	}
 
 	for (i = 0; i < mgr->queue_count; i++)
@@ -600,6 +610,7 @@ static int sde_rotator_secure_session_ctrl(bool enable)
 			vmid = VMID_CP_CAMERA_PREVIEW;
 
 			mdata->sec_cam_en = 1;
+			sde_mdp_buf_cache_flush();
 			sde_smmu_secure_ctrl(0);
 
 			ret = qcom_scm_mem_protect_sd_ctrl(SDE_ROTATOR_DEVICE,
@@ -803,6 +814,10 @@ static int sde_rotator_import_data(struct sde_rot_mgr *mgr,
 	if (entry->item.flags & SDE_ROTATION_SECURE_CAMERA)
 		flag |= SDE_SECURE_CAMERA_SESSION;
 
+	/* cached buffer mappings are owned by the requesting session */
+	entry->src_buf.owner = entry->private;
+	entry->dst_buf.owner = entry->private;
+
 	ret = sde_rotator_import_buffer(input, &entry->src_buf, flag,
 				&mgr->pdev->dev, true);
 	if (ret) {
@@ -1153,6 +1168,40 @@ static void sde_rotator_deinit_queue(struct sde_rot_mgr *mgr)
 	mgr->queue_count = 0;
 }
 
+/*
+ * sde_rotator_select_queue() - Function select commit queue for a session
+ * @mgr:	Rotator manager.
+ * @prio:	Queue index matching the session priority
+ * @perf:	Session performance struct holding its work distribution
+ *
+ * Work of a session stays on the queue it already has work on, so that
+ * entries of one session retire in order. Otherwise the session's own
+ * queue is used unless it has pending work, in which case an idle higher
+ * priority queue is borrowed. Lower priority queues are never used.
+ */
+static u32 sde_rotator_select_queue(struct sde_rot_mgr *mgr, u32 prio,
+	struct sde_rot_perf *perf)
+{
+	struct sde_rot_hw_resource *hw;
+	int i;
+
+	for (i = 0; i < mgr->queue_count; i++)
+		if (perf->work_distribution[i])
+			return i;
+
+	hw = mgr->commitq[prio].hw;
+	if (!hw || !hw->pending_count)
+		return prio;
+
+	for (i = 0; i < prio; i++) {
+		hw = mgr->commitq[i].hw;
+		if (!hw || !hw->pending_count)
+			return i;
+	}
+
+	return prio;
+}
+
 /*
  * sde_rotator_assign_queue() - Function assign rotation work onto hw
  * @mgr:	Rotator manager.
@@ -1176,14 +1225,25 @@ static int sde_rotator_assign_queue(struct sde_rot_mgr *mgr,
 	u32 pipe_idx = item->pipe_idx;
 	int ret = 0;
 
+	perf = sde_rotator_find_session(private, item->session_id);
+	if (!perf) {
+		SDEROT_ERR(
+			"Could not find session based on rotation work item\n");
+		return -EINVAL;
+	}
+
 	if (wb_idx >= mgr->queue_count) {
 		/* assign to the lowest priority queue */
 		wb_idx = mgr->queue_count - 1;
 	}
 
+	if (mgr->multi_queue)
+		wb_idx = sde_rotator_select_queue(mgr, wb_idx, perf);
+
+	entry->perf = perf;
 	entry->doneq = &mgr->doneq[wb_idx];
 	entry->commitq = &mgr->commitq[wb_idx];
-	queue = mgr->commitq;
+	queue = mgr->multi_queue ? entry->commitq : mgr->commitq;
 
 	if (!queue->hw) {
 		hw = mgr->ops_hw_alloc(mgr, pipe_idx, wb_idx);
@@ -1198,16 +1258,12 @@ static int sde_rotator_assign_queue(struct sde_rot_mgr *mgr,
 	if (queue->hw) {
 		entry->commitq = queue;
 		queue->hw->pending_count++;
-	}
 
-	perf = sde_rotator_find_session(private, item->session_id);
-	if (!perf) {
-		SDEROT_ERR(
-			"Could not find session based on rotation work item\n");
-		return -EINVAL;
+		/* account here so later entries of the request stay along */
+		perf->work_distribution[queue->hw->wb_id]++;
+		entry->work_assigned = true;
 	}
 
-	entry->perf = perf;
 	perf->last_wb_idx = wb_idx;
 
 	return ret;
@@ -1243,7 +1299,6 @@ void sde_rotator_queue_request(struct sde_rot_mgr *mgr,
 {
 	struct sde_rot_entry *entry;
 	struct sde_rot_queue *queue;
-	u32 wb_idx;
 	int i;
 
 	if (!mgr || !private || !req) {
@@ -1259,14 +1314,7 @@ void sde_rotator_queue_request(struct sde_rot_mgr *mgr,
 	for (i = 0; i < req->count; i++) {
 		entry = req->entries + i;
 		queue = entry->commitq;
-		wb_idx = queue->hw->wb_id;
-		entry->perf->work_distribution[wb_idx]++;
-		entry->work_assigned = true;
-	}
-
-	for (i = 0; i < req->count; i++) {
-		entry = req->entries + i;
-		queue = entry->commitq;
+		queue->dispatch_cnt++;
 		entry->output_fence = NULL;
 
 		if (entry->item.ts)
@@ -1645,6 +1693,72 @@ get_hw_res_err:
 	sde_rot_mgr_unlock(mgr);
 }
 
+static void sde_rotator_lat_hist_add(struct sde_rot_lat_hist *hist,
+		const u32 *lat_us)
+{
+	struct sde_rot_lat_stats *stats;
+	u32 bucket;
+	int i;
+
+	hist->count++;
+	for (i = 0; i < SDE_ROT_LAT_MAX; i++) {
+		stats = &hist->stage[i];
+		bucket = lat_us[i] >> SDE_ROT_LAT_BUCKET_SHIFT;
+		bucket = bucket ? fls(bucket) : 0;
+		if (bucket >= SDE_ROT_LAT_BUCKETS)
+			bucket = SDE_ROT_LAT_BUCKETS - 1;
+
+		stats->bucket[bucket]++;
+		stats->total_us += lat_us[i];
+		if (lat_us[i] > stats->max_us)
+			stats->max_us = lat_us[i];
+	}
+}
+
+static u32 sde_rotator_lat_us(ktime_t end, ktime_t start)
+{
+	s64 delta = ktime_us_delta(end, start);
+
+	return clamp_t(s64, delta, 0, U32_MAX);
+}
+
+/*
+ * sde_rotator_update_lat_hist - account retired entry in latency histograms
+ * @mgr: Pointer to rotator manager
+ * @entry: Pointer to retired rotation entry with valid timestamps
+ *
+ * Caller must hold the rotator manager lock, and must call this before the
+ * entry is released since the release may free the session perf context.
+ */
+static void sde_rotator_update_lat_hist(struct sde_rot_mgr *mgr,
+		struct sde_rot_entry *entry)
+{
+	ktime_t *ts = entry->item.ts;
+	u32 lat_us[SDE_ROT_LAT_MAX];
+	ktime_t start;
+
+	start = ktime_before(ts[SDE_ROTATOR_TS_SRCQB],
+			ts[SDE_ROTATOR_TS_DSTQB]) ?
+			ts[SDE_ROTATOR_TS_SRCQB] : ts[SDE_ROTATOR_TS_DSTQB];
+
+	lat_us[SDE_ROT_LAT_QUEUE] =
+		sde_rotator_lat_us(ts[SDE_ROTATOR_TS_FENCE], start);
+	lat_us[SDE_ROT_LAT_FENCE] = sde_rotator_lat_us(
+		ts[SDE_ROTATOR_TS_QUEUE], ts[SDE_ROTATOR_TS_FENCE]);
+	lat_us[SDE_ROT_LAT_COMMIT] = sde_rotator_lat_us(
+		ts[SDE_ROTATOR_TS_FLUSH], ts[SDE_ROTATOR_TS_QUEUE]);
+	lat_us[SDE_ROT_LAT_HW] = sde_rotator_lat_us(
+		ts[SDE_ROTATOR_TS_DONE], ts[SDE_ROTATOR_TS_FLUSH]);
+	lat_us[SDE_ROT_LAT_RETIRE] = sde_rotator_lat_us(
+		ts[SDE_ROTATOR_TS_RETIRE], ts[SDE_ROTATOR_TS_DONE]);
+	lat_us[SDE_ROT_LAT_TOTAL] =
+		sde_rotator_lat_us(ts[SDE_ROTATOR_TS_RETIRE], start);
+
+	sde_rotator_lat_hist_add(&mgr->lat_hist, lat_us);
+	if (entry->perf)
+		sde_rotator_lat_hist_add(&entry->perf->lat_hist, lat_us);
+}
+
 /*
  * sde_rotator_done_handler - Done workqueue handler.
  * @file: Pointer to work struct.
@@ -1720,13 +1834,15 @@ static void sde_rotator_done_handler(struct kthread_work *work)
 	sde_rot_mgr_lock(mgr);
 	sde_rotator_put_hw_resource(entry->commitq, entry, entry->commitq->hw);
 	sde_rotator_signal_output(entry);
+	if (entry->item.ts) {
+		entry->item.ts[SDE_ROTATOR_TS_RETIRE] = ktime_get();
+		sde_rotator_update_lat_hist(mgr, entry);
+	}
 	ATRACE_INT("sde_rot_done", 1);
 	sde_rotator_release_entry(mgr, entry);
 	atomic_dec(&request->pending_count);
 	if (request->retire_kw && request->retire_work)
 		kthread_queue_work(request->retire_kw, request->retire_work);
-	if (entry->item.ts)
-		entry->item.ts[SDE_ROTATOR_TS_RETIRE] = ktime_get();
 	sde_rot_mgr_unlock(mgr);
 
 	ATRACE_INT("sde_smmu_ctrl", 3);
@@ -2665,6 +2781,9 @@ static int sde_rotator_close(struct sde_rot_mgr *mgr,
 	sde_rotator_secure_session_ctrl(false);
 	sde_rotator_release_rotator_perf_session(mgr, private);
 
+	/* drop the cached mappings of this session */
+	sde_mdp_buf_cache_release(private);
+
 	list_del_init(&private->list);
 	devm_kfree(&mgr->pdev->dev, private);
 
@@ -2721,18 +2840,115 @@ static ssize_t state_show(struct device *dev,
 			SPRINT("%s=%lu\n", mgr->rot_clk[i].clk_name,
 					clk_get_rate(mgr->rot_clk[i].clk));
 
+	for (i = 0; mgr->commitq && i < mgr->queue_count; i++)
+		SPRINT("commitq%d: pending=%u dispatched=%llu\n", i,
+				mgr->commitq[i].hw ?
+				mgr->commitq[i].hw->pending_count : 0,
+				mgr->commitq[i].dispatch_cnt);
+
 	if (mgr->ops_hw_show_state)
 		cnt += mgr->ops_hw_show_state(mgr, attr, buf + cnt, len - cnt);
 
 	return cnt;
 }
 
+static const char * const sde_rot_lat_stage_name[SDE_ROT_LAT_MAX] = {
+	[SDE_ROT_LAT_QUEUE] = "queue",
+	[SDE_ROT_LAT_FENCE] = "fence",
+	[SDE_ROT_LAT_COMMIT] = "commit",
+	[SDE_ROT_LAT_HW] = "hw",
+	[SDE_ROT_LAT_RETIRE] = "retire",
+	[SDE_ROT_LAT_TOTAL] = "total",
+};
+
+static ssize_t latency_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	size_t len = PAGE_SIZE;
+	int cnt = 0;
+	struct sde_rot_mgr *mgr = sde_rot_mgr_from_device(dev);
+	struct sde_rot_file_private *priv;
+	struct sde_rot_lat_stats *stats;
+	struct sde_rot_lat_hist *hist;
+	struct sde_rot_perf *perf;
+	int i, j;
+
+	if (!mgr)
+		return cnt;
+
+#define SPRINT(fmt, ...) \
+		(cnt += scnprintf(buf + cnt, len - cnt, fmt, ##__VA_ARGS__))
+
+	sde_rot_mgr_lock(mgr);
+
+	hist = &mgr->lat_hist;
+	SPRINT("count=%u\n", hist->count);
+	SPRINT("%-7s %8s %8s", "stage", "avg_us", "max_us");
+	for (j = 0; j < SDE_ROT_LAT_BUCKETS - 1; j++)
+		SPRINT(" <%u", 1U << (SDE_ROT_LAT_BUCKET_SHIFT + j));
+	SPRINT(" >=%u\n", 1U << (SDE_ROT_LAT_BUCKET_SHIFT + j - 1));
+
+	for (i = 0; i < SDE_ROT_LAT_MAX; i++) {
+		stats = &hist->stage[i];
+		SPRINT("%-7s %8llu %8u", sde_rot_lat_stage_name[i],
+				hist->count ?
+				div_u64(stats->total_us, hist->count) : 0,
+				stats->max_us);
+		for (j = 0; j < SDE_ROT_LAT_BUCKETS; j++)
+			SPRINT(" %u", stats->bucket[j]);
+		SPRINT("\n");
+	}
+
+	/* per session summary: average and max of each stage */
+	list_for_each_entry(priv, &mgr->file_list, list) {
+		list_for_each_entry(perf, &priv->perf_list, list) {
+			hist = &perf->lat_hist;
+			SPRINT("session %u: count=%u", perf->config.session_id,
+					hist->count);
+			for (i = 0; i < SDE_ROT_LAT_MAX; i++) {
+				stats = &hist->stage[i];
+				SPRINT(" %s=%llu/%u",
+					sde_rot_lat_stage_name[i],
+					hist->count ? div_u64(stats->total_us,
+					hist->count) : 0, stats->max_us);
+			}
+			SPRINT("\n");
+		}
+	}
+
+	sde_rot_mgr_unlock(mgr);
+
+	return cnt;
+}
+
+static ssize_t latency_store(struct device *dev,
+		struct device_attribute *attr, const char *buf, size_t count)
+{
+	struct sde_rot_mgr *mgr = sde_rot_mgr_from_device(dev);
+	struct sde_rot_file_private *priv;
+	struct sde_rot_perf *perf;
+
+	if (!mgr)
+		return -ENODEV;
+
+	sde_rot_mgr_lock(mgr);
+	memset(&mgr->lat_hist, 0, sizeof(mgr->lat_hist));
+	list_for_each_entry(priv, &mgr->file_list, list)
+		list_for_each_entry(perf, &priv->perf_list, list)
+			memset(&perf->lat_hist, 0, sizeof(perf->lat_hist));
+	sde_rot_mgr_unlock(mgr);
+
+	return count;
+}
+
 static DEVICE_ATTR_RO(caps);
 static DEVICE_ATTR_RO(state);
+static DEVICE_ATTR_RW(latency);
 
 static struct attribute *sde_rotator_fs_attrs[] = {
 	&dev_attr_caps.attr,
 	&dev_attr_state.attr,
+	&dev_attr_latency.attr,
 	NULL
 };
 
@@ -2825,6 +3041,9 @@ static int sde_rotator_parse_dt(struct sde_rot_mgr *mgr,
 		mgr->queue_count = data;
 	}
 
+	mgr->sw_backend = of_property_read_bool(dev->dev.of_node,
+		"qcom,sde-rotator-sw");
+
 	ret = sde_rotator_parse_dt_bus(mgr, dev);
 	if (ret)
 		SDEROT_ERR("Failed to parse bus data\n");
@@ -3112,6 +3331,18 @@ int sde_rotator_core_init(struct sde_rot_mgr **pmgr,
 	}
 
 	*pmgr = mgr;
+
+	/*
+	 * The software backend rotates on the cpu and never accesses the
+	 * rotator block, so select it before the block is powered up and
+	 * queried. Buffers are still attached and mapped through the rotator
+	 * smmu context banks, which must remain available.
+	 */
+	if (mgr->sw_backend) {
+		mgr->ops_hw_init = sde_rotator_sw_init;
+		goto hw_init;
+	}
+
 	ret = sde_rotator_footswitch_ctrl(mgr, true);
 	if (ret) {
 		SDEROT_INFO("res_init failed %d, use probe defer\n", ret);
@@ -3167,6 +3398,7 @@ int sde_rotator_core_init(struct sde_rot_mgr **pmgr,
 		goto error_map_hw_ops;
 	}
 
+hw_init:
 	ret = mgr->ops_hw_init(mgr);
 	if (ret) {
 		SDEROT_ERR("hw init failed %d\n", ret);
@@ -3180,9 +3412,11 @@ int sde_rotator_core_init(struct sde_rot_mgr **pmgr,
 	}
 
 	/* disable power and clock after h/w initialization/query */
-	sde_rotator_clk_ctrl(mgr, false);
-	sde_rotator_resource_ctrl(mgr, false);
-	sde_rotator_footswitch_ctrl(mgr, false);
+	if (!mgr->sw_backend) {
+		sde_rotator_clk_ctrl(mgr, false);
+		sde_rotator_resource_ctrl(mgr, false);
+		sde_rotator_footswitch_ctrl(mgr, false);
+	}
 	pm_runtime_set_suspended(&pdev->dev);
 	pm_runtime_enable(&pdev->dev);
 
@@ -3192,9 +3426,11 @@ error_init_queue:
 	mgr->ops_hw_destroy(mgr);
 error_hw_init:
 error_map_hw_ops:
-	sde_rotator_clk_ctrl(mgr, false);
-	sde_rotator_resource_ctrl(mgr, false);
-	sde_rotator_footswitch_ctrl(mgr, false);
+	if (!mgr->sw_backend) {
+		sde_rotator_clk_ctrl(mgr, false);
+		sde_rotator_resource_ctrl(mgr, false);
+		sde_rotator_footswitch_ctrl(mgr, false);
+	}
 error_fs_en_fail:
 	sde_rotator_res_destroy(mgr);
 error_res_init:
@@ -3219,6 +3455,7 @@ void sde_rotator_core_destroy(struct sde_rot_mgr *mgr)
 	sde_rotator_deinit_queue(mgr);
 	mgr->ops_hw_destroy(mgr);
 	sde_rotator_release_all(mgr);
+	sde_mdp_buf_cache_flush();
 	pm_runtime_disable(mgr->device);
 	sde_rotator_res_destroy(mgr);
 	sysfs_remove_group(&mgr->device->kobj, &sde_rotator_fs_attr_group);
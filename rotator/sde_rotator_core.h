@@ -249,6 +249,7 @@ struct sde_rot_queue {
 	struct task_struct *rot_thread;
 	struct sde_rot_timeline *timeline;
 	struct sde_rot_hw_resource *hw;
+	u64 dispatch_cnt;	/* entries queued on this queue */
 };
 
 struct sde_rot_queue_v1 {
@@ -351,6 +352,55 @@ struct sde_rot_trace_entry {
 	u32 dst_h;
 };
 
+/*
+ * enum sde_rot_lat_stage - rotator request latency stages
+ * @SDE_ROT_LAT_QUEUE: earliest buffer queue to fence wait start
+ * @SDE_ROT_LAT_FENCE: fence wait start to request queued to commit queue
+ * @SDE_ROT_LAT_COMMIT: commit queue to hardware flush
+ * @SDE_ROT_LAT_HW: hardware flush to hardware done
+ * @SDE_ROT_LAT_RETIRE: hardware done to output fence retire
+ * @SDE_ROT_LAT_TOTAL: earliest buffer queue to output fence retire
+ */
+enum sde_rot_lat_stage {
+	SDE_ROT_LAT_QUEUE,
+	SDE_ROT_LAT_FENCE,
+	SDE_ROT_LAT_COMMIT,
+	SDE_ROT_LAT_HW,
+	SDE_ROT_LAT_RETIRE,
+	SDE_ROT_LAT_TOTAL,
+	SDE_ROT_LAT_MAX
+};
+
+/*
+ * Latency histogram buckets are powers of two starting at 32us; bucket 0
+ * counts samples below 32us, bucket n samples below (32 << n) us, and the
+ * last bucket is open ended.
+ */
+#define SDE_ROT_LAT_BUCKETS	12
+#define SDE_ROT_LAT_BUCKET_SHIFT	5
+
+/*
+ * struct sde_rot_lat_stats - latency statistics of one stage
+ * @total_us: sum of all samples in usec
+ * @max_us: largest sample in usec
+ * @bucket: histogram of samples
+ */
+struct sde_rot_lat_stats {
+	u64 total_us;
+	u32 max_us;
+	u32 bucket[SDE_ROT_LAT_BUCKETS];
+};
+
+/*
+ * struct sde_rot_lat_hist - per stage latency histogram
+ * @count: number of retired entries accounted
+ * @stage: statistics of each stage
+ */
+struct sde_rot_lat_hist {
+	u32 count;
+	struct sde_rot_lat_stats stage[SDE_ROT_LAT_MAX];
+};
+
 /*
  * struct sde_rot_perf - rotator session performance configuration
  * @list: list of performance configuration under one session
@@ -362,6 +412,7 @@ struct sde_rot_trace_entry {
  * @last_wb_idx: last queue/unit index, used to account for pre-distributed work
  * @rdot_limit: read OT limit of this session
  * @wrot_limit: write OT limit of this session
+ * @lat_hist: latency histogram of entries retired by this session
  */
 struct sde_rot_perf {
 	struct list_head list;
@@ -373,6 +424,7 @@ struct sde_rot_perf {
 	int last_wb_idx; /* last known wb index, used when above count is 0 */
 	u32 rdot_limit;
 	u32 wrot_limit;
+	struct sde_rot_lat_hist lat_hist;
 };
 
 /*
@@ -413,8 +465,11 @@ struct sde_rot_bus_data_type {
  * @pdev: pointer to controlling platform device
  * @device: pointer to controlling device
  * @queue_count: number of hardware queue/unit available
+ * @multi_queue: true if each commit queue owns its hw resource and is
+ *	scheduled independently; otherwise all work goes through commitq[0]
  * @commitq: array of rotator commit queue corresponding to hardware queue
  * @doneq: array of rotator done queue corresponding to hardware queue
+ * @sw_backend: true to rotate on the cpu instead of the rotator hardware
  * @file_list: list of all sessions managed by rotator manager
  * @pending_close_bw_vote: bandwidth of closed sessions with pending work
  * @minimum_bw_vote: minimum bandwidth required for current use case
@@ -436,6 +491,7 @@ struct sde_rot_bus_data_type {
  * @min_rot_clk: minimum rotator clock rate
  * @max_rot_clk: maximum allowed rotator clock rate
  * @sbuf_ctx: pointer to sbuf session context
+ * @lat_hist: latency histogram of all retired entries
  * @ops_xxx: function pointers of rotator HAL layer
  * @hw_data: private handle of rotator HAL layer
  */
@@ -450,8 +506,10 @@ struct sde_rot_mgr {
 	 * how many hw pipes available on the system
 	 */
 	int queue_count;
+	bool multi_queue;
 	struct sde_rot_queue *commitq;
 	struct sde_rot_queue *doneq;
+	bool sw_backend;
 
 	/*
 	 * managing all the open file sessions to bw calculations,
@@ -485,6 +543,8 @@ struct sde_rot_mgr {
 
 	struct sde_rot_file_private *sbuf_ctx;
 
+	struct sde_rot_lat_hist lat_hist;
+
 	int (*ops_config_hw)(struct sde_rot_hw_resource *hw,
 			struct sde_rot_entry *entry);
 	int (*ops_cancel_hw)(struct sde_rot_hw_resource *hw,
@@ -870,6 +870,64 @@ static int sde_rotator_raw_open(struct inode *inode, struct file *file)
 	return single_open(file, sde_rotator_raw_show, inode->i_private);
 }
 
+/*
+ * sde_rotator_buf_cache_show - Show dma-buf mapping cache statistics
+ * @s: Pointer to sequence file structure
+ * @data: Pointer to private data structure
+ */
+static int sde_rotator_buf_cache_show(struct seq_file *s, void *data)
+{
+	struct sde_mdp_buf_cache_stats stats;
+
+	sde_mdp_buf_cache_get_stats(&stats);
+
+	seq_printf(s, "count=%u\n", stats.count);
+	seq_printf(s, "max_count=%u\n", stats.max_count);
+	seq_printf(s, "hits=%llu\n", stats.hits);
+	seq_printf(s, "misses=%llu\n", stats.misses);
+	seq_printf(s, "evictions=%llu\n", stats.evictions);
+	seq_printf(s, "releases=%llu\n", stats.releases);
+
+	return 0;
+}
+
+static int sde_rotator_buf_cache_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, sde_rotator_buf_cache_show, inode->i_private);
+}
+
+/*
+ * sde_rotator_buf_cache_write - Resize mapping cache and reset statistics
+ *
+ * Writing the maximum number of cached mappings resets the statistics,
+ * writing 0 disables the cache.
+ */
+static ssize_t sde_rotator_buf_cache_write(struct file *file,
+		const char __user *user_buf, size_t count, loff_t *ppos)
+{
+	u32 max_count;
+	int ret;
+
+	ret = kstrtou32_from_user(user_buf, count, 0, &max_count);
+	if (ret)
+		return ret;
+
+	sde_mdp_buf_cache_set_max(max_count);
+
+	return count;
+}
+
+/*
+ * struct sde_rotator_buf_cache_ops - mapping cache file operations
+ */
+static const struct file_operations sde_rotator_buf_cache_ops = {
+	.open		= sde_rotator_buf_cache_open,
+	.read		= seq_read,
+	.write		= sde_rotator_buf_cache_write,
+	.llseek		= seq_lseek,
+	.release	= single_release
+};
+
 /*
  * sde_rotator_dbg_open - Raw statistics debugfs file open function
  * @mdata: Pointer to rotator global data
@@ -914,6 +972,12 @@ static int sde_rotator_core_create_debugfs(
 		return -EINVAL;
 	}
 
+	if (!debugfs_create_file("buf_cache", 0644,
+			debugfs_root, NULL, &sde_rotator_buf_cache_ops)) {
+		SDEROT_WARN("failed to create buf_cache\n");
+		return -EINVAL;
+	}
+
 	if (mgr->ops_hw_create_debugfs) {
 		ret = mgr->ops_hw_create_debugfs(mgr, debugfs_root);
 		if (ret)
@@ -656,6 +656,10 @@ static int sde_rotator_s_ctrl(struct v4l2_ctrl *ctrl)
 	case V4L2_CID_SDE_ROTATOR_SECURE_CAMERA:
 		ret = sde_rotator_s_ctx_ctrl(ctx, &ctx->secure_camera, ctrl);
 		break;
+
+	case V4L2_CID_SDE_ROTATOR_BATCH_DEPTH:
+		ret = sde_rotator_s_ctx_ctrl(ctx, &ctx->batch_depth, ctrl);
+		break;
 	default:
 		v4l2_warn(&rot_dev->v4l2_dev, "invalid control %d\n", ctrl->id);
 		ret = -EINVAL;
@@ -697,6 +701,20 @@ static const struct v4l2_ctrl_config sde_rotator_ctrl_secure_camera = {
 	.step = 1,
 };
 
+/*
+ * sde_rotator_ctrl_batch_depth - Buffer pairs per request.
+ */
+static const struct v4l2_ctrl_config sde_rotator_ctrl_batch_depth = {
+	.ops = &sde_rotator_ctrl_ops,
+	.id = V4L2_CID_SDE_ROTATOR_BATCH_DEPTH,
+	.name = "Batch Depth",
+	.type = V4L2_CTRL_TYPE_INTEGER,
+	.def = 1,
+	.min = 1,
+	.max = SDE_ROTATOR_BATCH_MAX,
+	.step = 1,
+};
+
 /*
  * sde_rotator_ctx_show - show context state.
  */
@@ -1013,7 +1031,7 @@ struct sde_rotator_ctx *sde_rotator_ctx_open(
 	if (ctx->file) {
 		/* Create control */
 		ctrl_handler = &ctx->ctrl_handler;
-		v4l2_ctrl_handler_init(ctrl_handler, 4);
+		v4l2_ctrl_handler_init(ctrl_handler, 6);
 		v4l2_ctrl_new_std(ctrl_handler,
 			&sde_rotator_ctrl_ops, V4L2_CID_HFLIP, 0, 1, 1, 0);
 		v4l2_ctrl_new_std(ctrl_handler,
@@ -1024,6 +1042,8 @@ struct sde_rotator_ctx *sde_rotator_ctx_open(
 			&sde_rotator_ctrl_secure, NULL);
 		v4l2_ctrl_new_custom(ctrl_handler,
 			&sde_rotator_ctrl_secure_camera, NULL);
+		v4l2_ctrl_new_custom(ctrl_handler,
+			&sde_rotator_ctrl_batch_depth, NULL);
 		if (ctrl_handler->error) {
 			ret = ctrl_handler->error;
 			v4l2_ctrl_handler_free(ctrl_handler);
@@ -2851,6 +2871,33 @@ static const struct v4l2_ioctl_ops sde_rotator_ioctl_ops = {
 	.vidioc_unsubscribe_event = sde_rotator_event_unsubscribe,
 };
 
+/*
+ * sde_rotator_buf_done_batch - Return processed buffer pairs to the client.
+ * @ctx: Pointer rotator context.
+ * @count: Number of buffer pairs to return.
+ * @state: Vb2 buffer state to return the buffers with.
+ */
+static void sde_rotator_buf_done_batch(struct sde_rotator_ctx *ctx,
+	u32 count, enum vb2_buffer_state state)
+{
+	struct vb2_v4l2_buffer *src_buf;
+	struct vb2_v4l2_buffer *dst_buf;
+	u32 i;
+
+	for (i = 0; i < count; i++) {
+		src_buf = v4l2_m2m_src_buf_remove(ctx->fh.m2m_ctx);
+		dst_buf = v4l2_m2m_dst_buf_remove(ctx->fh.m2m_ctx);
+		if (!src_buf || !dst_buf)
+			SDEDEV_ERR(ctx->rot_dev->dev,
+				"null buffer s:%d sb:%pK db:%pK\n",
+				ctx->session_id, src_buf, dst_buf);
+		if (src_buf)
+			v4l2_m2m_buf_done(src_buf, state);
+		if (dst_buf)
+			v4l2_m2m_buf_done(dst_buf, state);
+	}
+}
+
 /*
  * sde_rotator_retire_handler - Invoked by hal when processing is done.
  * @work: Pointer to work structure.
@@ -2859,8 +2906,6 @@ static const struct v4l2_ioctl_ops sde_rotator_ioctl_ops = {
  */
 static void sde_rotator_retire_handler(struct kthread_work *work)
 {
-	struct vb2_v4l2_buffer *src_buf;
-	struct vb2_v4l2_buffer *dst_buf;
 	struct sde_rotator_ctx *ctx;
 	struct sde_rotator_device *rot_dev;
 	struct sde_rotator_request *request;
@@ -2899,41 +2944,36 @@ static void sde_rotator_retire_handler(struct kthread_work *work)
 
 		/* pending request. reschedule this context. */
 		v4l2_m2m_try_schedule(ctx->fh.m2m_ctx);
+	} else if (!request->committed || (request->req &&
+			atomic_read(&request->req->pending_count))) {
+		/* already retired, or wait for the rest of the batch */
+		SDEDEV_DBG(rot_dev->dev, "skip retire s:%d\n",
+				ctx->session_id);
 	} else {
 		/* no pending request. acknowledge the usual way. */
-		src_buf = v4l2_m2m_src_buf_remove(ctx->fh.m2m_ctx);
-		dst_buf = v4l2_m2m_dst_buf_remove(ctx->fh.m2m_ctx);
-
-		if (!src_buf || !dst_buf) {
-			SDEDEV_ERR(rot_dev->dev,
-				"null buffer in retire s:%d sb:%pK db:%pK\n",
-				ctx->session_id,
-				src_buf, dst_buf);
-		}
-
 		sde_rotator_update_retire_sequence(request);
 		sde_rotator_retire_request(request);
-		v4l2_m2m_buf_done(src_buf, VB2_BUF_STATE_DONE);
-		v4l2_m2m_buf_done(dst_buf, VB2_BUF_STATE_DONE);
+		sde_rotator_buf_done_batch(ctx, request->count,
+				VB2_BUF_STATE_DONE);
 		v4l2_m2m_job_finish(rot_dev->m2m_dev, ctx->fh.m2m_ctx);
 	}
 	mutex_unlock(&rot_dev->lock);
 }
 
 /*
- * sde_rotator_process_buffers - Start rotator processing.
+ * sde_rotator_prepare_item - Prepare rotation item of one buffer pair.
  * @ctx: Pointer rotator context.
  * @src_buf: Pointer to Vb2 source buffer.
  * @dst_buf: Pointer to Vb2 destination buffer.
- * @request: Pointer to rotator request
+ * @item: Pointer to rotation item to fill in.
+ * @wait: true to wait for the source fence; otherwise return -EAGAIN if
+ *	the source fence is not signaled yet.
  */
-static int sde_rotator_process_buffers(struct sde_rotator_ctx *ctx,
+static int sde_rotator_prepare_item(struct sde_rotator_ctx *ctx,
 	struct vb2_buffer *src_buf, struct vb2_buffer *dst_buf,
-	struct sde_rotator_request *request)
+	struct sde_rotation_item *item, bool wait)
 {
 	struct sde_rotator_device *rot_dev = ctx->rot_dev;
-	struct sde_rotation_item item;
-	struct sde_rot_entry_container *req = NULL;
 	struct sde_rotator_buf_handle *src_handle;
 	struct sde_rotator_buf_handle *dst_handle;
 	struct sde_rotator_statistics *stats = &rot_dev->stats;
@@ -2945,8 +2985,7 @@ static int sde_rotator_process_buffers(struct sde_rotator_ctx *ctx,
 
 	if (!src_buf || !dst_buf) {
 		SDEDEV_ERR(rot_dev->dev, "null vb2 buffers\n");
-		ret = -EINVAL;
-		goto error_null_buffer;
+		return -EINVAL;
 	}
 
 	src_handle = src_buf->planes[0].mem_priv;
@@ -2954,13 +2993,20 @@ static int sde_rotator_process_buffers(struct sde_rotator_ctx *ctx,
 
 	if (!src_handle || !dst_handle) {
 		SDEDEV_ERR(rot_dev->dev, "null buffer handle\n");
-		ret = -EINVAL;
-		goto error_null_buffer;
+		return -EINVAL;
 	}
 
 	vbinfo_out = &ctx->vbinfo_out[src_buf->index];
 	vbinfo_cap = &ctx->vbinfo_cap[dst_buf->index];
 
+	/* only coalesce buffers whose source is ready */
+	if (!wait && vbinfo_out->fence) {
+		if (sde_rotator_wait_sync_fence(vbinfo_out->fence, 0))
+			return -EAGAIN;
+		sde_rotator_put_sync_fence(vbinfo_out->fence);
+		vbinfo_out->fence = NULL;
+	}
+
 	SDEDEV_DBG(rot_dev->dev,
 		"process buffer s:%d.%u src:(%u,%u,%u,%u) dst:(%u,%u,%u,%u) rot:%d flip:%d/%d sec:%d src_cr:%u/%u dst_cr:%u/%u\n",
 		ctx->session_id, vbinfo_cap->fence_ts,
@@ -3022,7 +3068,7 @@ static int sde_rotator_process_buffers(struct sde_rotator_ctx *ctx,
 			SDEROT_EVTLOG(ctx->session_id, vbinfo_cap->fence_ts,
 					vbinfo_out->fd, ret,
 					SDE_ROT_EVTLOG_ERROR);
-			goto error_fence_wait;
+			return ret;
 		} else {
 			SDEDEV_DBG(rot_dev->dev, "fence exit s:%d.%d fd:%d\n",
 				ctx->session_id,
@@ -3031,26 +3077,122 @@ static int sde_rotator_process_buffers(struct sde_rotator_ctx *ctx,
 	}
 
 	/* fill in item work structure */
-	sde_rotator_get_item_from_ctx(ctx, &item);
-	item.flags |= SDE_ROTATION_EXT_DMA_BUF;
-	item.input.planes[0].fd = src_handle->fd;
-	item.input.planes[0].buffer = src_handle->buffer;
-	item.input.planes[0].offset = src_handle->addr;
-	item.input.planes[0].stride = ctx->format_out.fmt.pix.bytesperline;
-	item.input.plane_count = 1;
-	item.input.fence = NULL;
-	item.input.comp_ratio = vbinfo_out->comp_ratio;
-	item.output.planes[0].fd = dst_handle->fd;
-	item.output.planes[0].buffer = dst_handle->buffer;
-	item.output.planes[0].offset = dst_handle->addr;
-	item.output.planes[0].stride = ctx->format_cap.fmt.pix.bytesperline;
-	item.output.plane_count = 1;
-	item.output.fence = NULL;
-	item.output.comp_ratio = vbinfo_cap->comp_ratio;
-	item.sequence_id = vbinfo_cap->fence_ts;
-	item.ts = ts;
-
-	req = sde_rotator_req_init(rot_dev->mgr, ctx->private, &item, 1, 0);
+	sde_rotator_get_item_from_ctx(ctx, item);
+	item->flags |= SDE_ROTATION_EXT_DMA_BUF;
+	item->input.planes[0].fd = src_handle->fd;
+	item->input.planes[0].buffer = src_handle->buffer;
+	item->input.planes[0].offset = src_handle->addr;
+	item->input.planes[0].stride = ctx->format_out.fmt.pix.bytesperline;
+	item->input.plane_count = 1;
+	item->input.fence = NULL;
+	item->input.comp_ratio = vbinfo_out->comp_ratio;
+	item->output.planes[0].fd = dst_handle->fd;
+	item->output.planes[0].buffer = dst_handle->buffer;
+	item->output.planes[0].offset = dst_handle->addr;
+	item->output.planes[0].stride = ctx->format_cap.fmt.pix.bytesperline;
+	item->output.plane_count = 1;
+	item->output.fence = NULL;
+	item->output.comp_ratio = vbinfo_cap->comp_ratio;
+	item->sequence_id = vbinfo_cap->fence_ts;
+	item->ts = ts;
+
+	return 0;
+}
+
+/*
+ * sde_rotator_get_ready_buffers - Get ready buffer pairs in queue order.
+ * @ctx: Pointer rotator context.
+ * @src_bufs: Array of source buffers to fill in.
+ * @dst_bufs: Array of destination buffers to fill in.
+ * @max_count: Maximum number of buffer pairs.
+ * return: number of buffer pairs
+ */
+static u32 sde_rotator_get_ready_buffers(struct sde_rotator_ctx *ctx,
+	struct vb2_buffer **src_bufs, struct vb2_buffer **dst_bufs,
+	u32 max_count)
+{
+	struct v4l2_m2m_ctx *m2m_ctx = ctx->fh.m2m_ctx;
+	struct v4l2_m2m_buffer *b;
+	unsigned long flags;
+	u32 src_count = 0;
+	u32 dst_count = 0;
+
+	spin_lock_irqsave(&m2m_ctx->out_q_ctx.rdy_spinlock, flags);
+	v4l2_m2m_for_each_src_buf(m2m_ctx, b) {
+		if (src_count >= max_count)
+			break;
+		src_bufs[src_count++] = &b->vb.vb2_buf;
+	}
+	spin_unlock_irqrestore(&m2m_ctx->out_q_ctx.rdy_spinlock, flags);
+
+	spin_lock_irqsave(&m2m_ctx->cap_q_ctx.rdy_spinlock, flags);
+	v4l2_m2m_for_each_dst_buf(m2m_ctx, b) {
+		if (dst_count >= max_count)
+			break;
+		dst_bufs[dst_count++] = &b->vb.vb2_buf;
+	}
+	spin_unlock_irqrestore(&m2m_ctx->cap_q_ctx.rdy_spinlock, flags);
+
+	return min(src_count, dst_count);
+}
+
+/*
+ * sde_rotator_process_buffers - Start rotator processing.
+ * @ctx: Pointer rotator context.
+ * @request: Pointer to rotator request
+ *
+ * The next source/destination buffer pair is always processed. Up to the
+ * context batch depth, the following pairs whose source is already ready
+ * are coalesced into the same request. On failure, the request accounts
+ * for the next buffer pair only.
+ */
+static int sde_rotator_process_buffers(struct sde_rotator_ctx *ctx,
+	struct sde_rotator_request *request)
+{
+	struct sde_rotator_device *rot_dev = ctx->rot_dev;
+	struct vb2_buffer *src_bufs[SDE_ROTATOR_BATCH_MAX];
+	struct vb2_buffer *dst_bufs[SDE_ROTATOR_BATCH_MAX];
+	struct vb2_buffer *src_buf, *dst_buf;
+	struct sde_rotation_item *items;
+	struct sde_rot_entry_container *req = NULL;
+	u32 max_count, count, i;
+	int ret;
+
+	max_count = clamp_t(s32, ctx->batch_depth, 1, SDE_ROTATOR_BATCH_MAX);
+
+	items = kcalloc(max_count, sizeof(*items), GFP_KERNEL);
+	if (!items) {
+		ret = -ENOMEM;
+		goto error_alloc_items;
+	}
+
+	if (!sde_rotator_get_ready_buffers(ctx, src_bufs, dst_bufs, 1)) {
+		SDEDEV_ERR(rot_dev->dev, "null vb2 buffers\n");
+		ret = -EINVAL;
+		goto error_null_buffer;
+	}
+
+	ret = sde_rotator_prepare_item(ctx, src_bufs[0], dst_bufs[0],
+			&items[0], true);
+	if (ret)
+		goto error_prepare_item;
+
+	/* queue may have changed while waiting for the fence */
+	src_buf = src_bufs[0];
+	dst_buf = dst_bufs[0];
+	count = sde_rotator_get_ready_buffers(ctx, src_bufs, dst_bufs,
+			max_count);
+	if (!count || src_bufs[0] != src_buf || dst_bufs[0] != dst_buf)
+		count = 1;
+	for (i = 1; i < count; i++) {
+		if (sde_rotator_prepare_item(ctx, src_bufs[i], dst_bufs[i],
+				&items[i], false))
+			break;
+	}
+	count = i;
+
+	req = sde_rotator_req_init(rot_dev->mgr, ctx->private, items,
+			count, 0);
 	if (IS_ERR_OR_NULL(req)) {
 		SDEDEV_ERR(rot_dev->dev, "fail allocate rotation request\n");
 		ret = -ENOMEM;
@@ -3069,17 +3211,22 @@ static int sde_rotator_process_buffers(struct sde_rotator_ctx *ctx,
 
 	sde_rotator_queue_request(rot_dev->mgr, ctx->private, req);
 	request->req = req;
-	request->sequence_id = item.sequence_id;
+	request->sequence_id = items[count - 1].sequence_id;
+	request->count = count;
 	request->committed = true;
+	kfree(items);
 
 	return 0;
 error_handle_request:
 	devm_kfree(rot_dev->dev, req);
 error_init_request:
-error_fence_wait:
+error_prepare_item:
 error_null_buffer:
+	kfree(items);
+error_alloc_items:
 	request->req = NULL;
 	request->sequence_id = 0;
+	request->count = 1;
 	request->committed = false;
 	return ret;
 }
@@ -3094,8 +3241,6 @@ static void sde_rotator_submit_handler(struct kthread_work *work)
 {
 	struct sde_rotator_ctx *ctx;
 	struct sde_rotator_device *rot_dev;
-	struct vb2_v4l2_buffer *src_buf;
-	struct vb2_v4l2_buffer *dst_buf;
 	struct sde_rotator_request *request;
 	int ret;
 
@@ -3121,11 +3266,8 @@ static void sde_rotator_submit_handler(struct kthread_work *work)
 	}
 
 	/* submit new request */
-	dst_buf = v4l2_m2m_next_dst_buf(ctx->fh.m2m_ctx);
-	src_buf = v4l2_m2m_next_src_buf(ctx->fh.m2m_ctx);
 	sde_rot_mgr_lock(rot_dev->mgr);
-	ret = sde_rotator_process_buffers(ctx, &src_buf->vb2_buf,
-			&dst_buf->vb2_buf, request);
+	ret = sde_rotator_process_buffers(ctx, request);
 	sde_rot_mgr_unlock(rot_dev->mgr);
 	if (ret) {
 		SDEDEV_ERR(rot_dev->dev,
@@ -3146,9 +3288,8 @@ static void sde_rotator_device_run(void *priv)
 {
 	struct sde_rotator_ctx *ctx = priv;
 	struct sde_rotator_device *rot_dev;
-	struct vb2_v4l2_buffer *src_buf;
-	struct vb2_v4l2_buffer *dst_buf;
 	struct sde_rotator_request *request;
+	u32 count;
 	int ret;
 
 	if (!ctx || !ctx->rot_dev) {
@@ -3198,20 +3339,10 @@ static void sde_rotator_device_run(void *priv)
 				goto error_process_buffers;
 			}
 
-			src_buf = v4l2_m2m_src_buf_remove(ctx->fh.m2m_ctx);
-			dst_buf = v4l2_m2m_dst_buf_remove(ctx->fh.m2m_ctx);
-			if (!src_buf || !dst_buf) {
-				SDEDEV_ERR(rot_dev->dev,
-					"null buffer in device run s:%d sb:%pK db:%pK\n",
-					ctx->session_id,
-					src_buf, dst_buf);
-				goto error_process_buffers;
-			}
-
 			sde_rotator_update_retire_sequence(request);
 			sde_rotator_retire_request(request);
-			v4l2_m2m_buf_done(src_buf, VB2_BUF_STATE_DONE);
-			v4l2_m2m_buf_done(dst_buf, VB2_BUF_STATE_DONE);
+			sde_rotator_buf_done_batch(ctx, request->count,
+					VB2_BUF_STATE_DONE);
 			v4l2_m2m_job_finish(rot_dev->m2m_dev, ctx->fh.m2m_ctx);
 		} else {
 			/* pending request not complete. something wrong. */
@@ -3243,19 +3374,8 @@ static void sde_rotator_device_run(void *priv)
 		spin_unlock(&ctx->list_lock);
 
 		/* no pending request. submit buffer the usual way. */
-		dst_buf = v4l2_m2m_next_dst_buf(ctx->fh.m2m_ctx);
-		src_buf = v4l2_m2m_next_src_buf(ctx->fh.m2m_ctx);
-		if (!src_buf || !dst_buf) {
-			SDEDEV_ERR(rot_dev->dev,
-				"null buffer in device run s:%d sb:%pK db:%pK\n",
-				ctx->session_id,
-				src_buf, dst_buf);
-			goto error_empty_buffer;
-		}
-
 		sde_rot_mgr_lock(rot_dev->mgr);
-		ret = sde_rotator_process_buffers(ctx, &src_buf->vb2_buf,
-				&dst_buf->vb2_buf, request);
+		ret = sde_rotator_process_buffers(ctx, request);
 		sde_rot_mgr_unlock(rot_dev->mgr);
 		if (ret) {
 			SDEDEV_ERR(rot_dev->dev,
@@ -3269,16 +3389,12 @@ static void sde_rotator_device_run(void *priv)
 
 	return;
 error_process_buffers:
-error_empty_buffer:
 error_retired_list:
+	/* fail all buffer pairs of the request */
+	count = request ? max_t(u32, request->count, 1) : 1;
 	sde_rotator_update_retire_sequence(request);
 	sde_rotator_retire_request(request);
-	src_buf = v4l2_m2m_src_buf_remove(ctx->fh.m2m_ctx);
-	dst_buf = v4l2_m2m_dst_buf_remove(ctx->fh.m2m_ctx);
-	if (src_buf)
-		v4l2_m2m_buf_done(src_buf, VB2_BUF_STATE_ERROR);
-	if (dst_buf)
-		v4l2_m2m_buf_done(dst_buf, VB2_BUF_STATE_ERROR);
+	sde_rotator_buf_done_batch(ctx, count, VB2_BUF_STATE_ERROR);
 	sde_rotator_resync_timeline(ctx->work_queue.timeline);
 	v4l2_m2m_job_finish(rot_dev->m2m_dev, ctx->fh.m2m_ctx);
 }
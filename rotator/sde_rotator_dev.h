@@ -33,6 +33,9 @@
 /* maximum number of outstanding requests per ctx session */
 #define SDE_ROTATOR_REQUEST_MAX		2
 
+/* maximum number of buffer pairs coalesced into one request */
+#define SDE_ROTATOR_BATCH_MAX		8
+
 #define MAX_ROT_OPEN_SESSION 16
 
 struct sde_rotator_device;
@@ -86,7 +89,8 @@ struct sde_rotator_vbinfo {
  *	 Avoid dereference in dev layer if possible.
  * @ctx: Pointer to parent context
  * @committed: true if request committed to hardware
- * @sequence_id: sequence identifier of this request
+ * @sequence_id: sequence identifier of the last buffer pair of this request
+ * @count: number of source/destination buffer pairs in this request
  */
 struct sde_rotator_request {
 	struct list_head list;
@@ -96,6 +100,7 @@ struct sde_rotator_request {
 	struct sde_rotator_ctx *ctx;
 	bool committed;
 	u32 sequence_id;
+	u32 count;
 };
 
 /*
@@ -115,6 +120,7 @@ struct sde_rotator_request {
  * @vflip: vertical flip (1-flip)
  * @rotate: rotation angle (0,90,180,270)
  * @secure: Non-secure (0) / Secure processing
+ * @batch_depth: maximum number of buffer pairs coalesced into one request
  * @abort_pending: True if abort is requested for async handling.
  * @nbuf_cap: Number of requested buffer for capture queue
  * @nbuf_out: Number of requested buffer for output queue
@@ -150,6 +156,7 @@ struct sde_rotator_ctx {
 	s32 rotate;
 	s32 secure;
 	s32 secure_camera;
+	s32 batch_depth;
 	int abort_pending;
 	int nbuf_cap;
 	int nbuf_out;
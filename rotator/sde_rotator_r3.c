@@ -4053,6 +4053,9 @@ int sde_rotator_r3_init(struct sde_rot_mgr *mgr)
 	if (ret)
 		goto error_parse_dt;
 
+	/* each priority queue has its own regdma command queue */
+	mgr->multi_queue = (rot->mode != ROT_REGDMA_OFF);
+
 	rot->irq_num = -EINVAL;
 	atomic_set(&rot->irq_enabled, 0);
 
@@ -0,0 +1,706 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#define pr_fmt(fmt)	"%s: " fmt, __func__
+
+#include <linux/platform_device.h>
+#include <linux/module.h>
+#include <linux/dma-buf.h>
+#include <linux/dma-direction.h>
+#include <linux/ktime.h>
+#include <linux/version.h>
+
+#include "sde_rotator_core.h"
+#include "sde_rotator_util.h"
+#include "sde_rotator_sw.h"
+
+/*
+ * Edge length in pixels of the square tiles used when the source is walked
+ * out of raster order. A tile of 32bpp pixels spans 32 source rows of 128
+ * bytes, small enough for both sides of the transform to stay in L1.
+ */
+#define SDE_ROT_SW_TILE		32
+
+/*
+ * struct sde_rot_sw_resource - software rotator queue resource
+ * @hw: generic rotator queue resource
+ * @count: number of entries processed on this queue
+ * @failed: number of entries which failed to process
+ * @bytes: number of output bytes written
+ * @time_us: cumulative processing time in usec
+ */
+struct sde_rot_sw_resource {
+	struct sde_rot_hw_resource hw;
+	u64 count;
+	u64 failed;
+	u64 bytes;
+	u64 time_us;
+};
+
+/*
+ * struct sde_rot_sw_data - software rotator private data
+ * @mgr: Pointer to rotator manager
+ */
+struct sde_rot_sw_data {
+	struct sde_rot_mgr *mgr;
+};
+
+/*
+ * struct sde_rot_sw_buf - cpu mapping of a rotator buffer
+ * @num_planes: number of valid planes
+ * @dmabuf: dma-buf mapped for each plane, NULL if the plane shares the
+ *	mapping of the previous plane
+ * @map: kernel mapping of each dma-buf
+ * @vaddr: kernel address of the first pixel of each plane
+ * @stride: line stride in bytes of each plane
+ */
+struct sde_rot_sw_buf {
+	u32 num_planes;
+	struct dma_buf *dmabuf[SDE_ROT_MAX_PLANES];
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(5, 19, 0))
+	struct iosys_map map[SDE_ROT_MAX_PLANES];
+#else
+	struct dma_buf_map map[SDE_ROT_MAX_PLANES];
+#endif
+	u8 *vaddr[SDE_ROT_MAX_PLANES];
+	u32 stride[SDE_ROT_MAX_PLANES];
+};
+
+/*
+ * struct sde_rot_sw_xfrm - per plane pixel transform
+ * @src: source pixel which lands on the first destination pixel
+ * @src_dx: source byte step for each destination column
+ * @src_dy: source byte step for each destination row
+ * @dst: first destination pixel
+ * @dst_stride: destination line stride in bytes
+ * @width: destination width in pixels
+ * @height: destination height in pixels
+ * @cpp: bytes per pixel
+ */
+struct sde_rot_sw_xfrm {
+	const u8 *src;
+	ssize_t src_dx;
+	ssize_t src_dy;
+	u8 *dst;
+	u32 dst_stride;
+	int width;
+	int height;
+	u32 cpp;
+};
+
+static u32 sde_rot_sw_pixfmts[] = {
+	SDE_PIX_FMT_XRGB_8888,
+	SDE_PIX_FMT_ARGB_8888,
+	SDE_PIX_FMT_ABGR_8888,
+	SDE_PIX_FMT_RGBA_8888,
+	SDE_PIX_FMT_BGRA_8888,
+	SDE_PIX_FMT_RGBX_8888,
+	SDE_PIX_FMT_BGRX_8888,
+	SDE_PIX_FMT_XBGR_8888,
+	SDE_PIX_FMT_RGB_565,
+	SDE_PIX_FMT_BGR_565,
+	SDE_PIX_FMT_Y_CBCR_H2V2,
+	SDE_PIX_FMT_Y_CRCB_H2V2,
+};
+
+/*
+ * sde_rot_sw_copy_row - copy one destination row
+ * @dst: Pointer to first destination pixel
+ * @src: Pointer to first source pixel
+ * @step: source byte step between consecutive destination pixels
+ * @n: number of pixels to copy
+ * @cpp: bytes per pixel
+ */
+static inline void sde_rot_sw_copy_row(u8 *dst, const u8 *src, ssize_t step,
+		int n, u32 cpp)
+{
+	int i;
+
+	switch (cpp) {
+	case 4: {
+		u32 *d = (u32 *)dst;
+
+		for (i = 0; i < n; i++, src += step)
+			d[i] = *(const u32 *)src;
+		break;
+	}
+	case 2: {
+		u16 *d = (u16 *)dst;
+
+		for (i = 0; i < n; i++, src += step)
+			d[i] = *(const u16 *)src;
+		break;
+	}
+	default:
+		for (i = 0; i < n; i++, src += step)
+			dst[i] = *src;
+		break;
+	}
+}
+
+/*
+ * sde_rot_sw_xfrm_plane - apply the transform to one plane
+ * @x: Pointer to plane transform
+ *
+ * Transforms which keep each row in source order (no rotation and no
+ * left/right flip) are copied line by line. Everything else walks the
+ * destination in square tiles so that the strided source reads of a tile
+ * reuse the same cache lines instead of touching a new line for every
+ * pixel of a full row.
+ */
+static void sde_rot_sw_xfrm_plane(const struct sde_rot_sw_xfrm *x)
+{
+	int tx, ty, tw, th, j;
+
+	if (x->src_dx == (ssize_t)x->cpp) {
+		for (j = 0; j < x->height; j++)
+			memcpy(x->dst + (ssize_t)j * x->dst_stride,
+					x->src + (ssize_t)j * x->src_dy,
+					(size_t)x->width * x->cpp);
+		return;
+	}
+
+	for (ty = 0; ty < x->height; ty += SDE_ROT_SW_TILE) {
+		th = min_t(int, x->height - ty, SDE_ROT_SW_TILE);
+		for (tx = 0; tx < x->width; tx += SDE_ROT_SW_TILE) {
+			tw = min_t(int, x->width - tx, SDE_ROT_SW_TILE);
+			for (j = ty; j < ty + th; j++)
+				sde_rot_sw_copy_row(
+					x->dst + (ssize_t)j * x->dst_stride +
+						(ssize_t)tx * x->cpp,
+					x->src + (ssize_t)tx * x->src_dx +
+						(ssize_t)j * x->src_dy,
+					x->src_dx, tw, x->cpp);
+		}
+	}
+}
+
+/*
+ * sde_rot_sw_setup_xfrm - compute the transform of one plane
+ * @item: Pointer to rotation item
+ * @src: Pointer to source buffer mapping
+ * @dst: Pointer to destination buffer mapping
+ * @plane: plane index
+ * @sub: chroma subsampling factor of the plane
+ * @cpp: bytes per pixel of the plane
+ * @x: Pointer to transform to fill
+ *
+ * Flips are applied to the source first, followed by the clockwise 90
+ * degree rotation, matching the hardware rotator. Destination pixel (dx, dy)
+ * is fetched from source (sx, sy), both linear in dx and dy, so the whole
+ * transform reduces to a start pointer and two signed byte steps.
+ */
+static void sde_rot_sw_setup_xfrm(struct sde_rotation_item *item,
+		struct sde_rot_sw_buf *src, struct sde_rot_sw_buf *dst,
+		int plane, u32 sub, u32 cpp, struct sde_rot_sw_xfrm *x)
+{
+	ssize_t sstride = src->stride[plane];
+	int sw = item->src_rect.w / sub;
+	int sh = item->src_rect.h / sub;
+	int x0, xdx, xdy, y0, ydx, ydy;
+
+	if (item->flags & SDE_ROTATION_90) {
+		x0 = 0;
+		xdx = 0;
+		xdy = 1;
+		y0 = sh - 1;
+		ydx = -1;
+		ydy = 0;
+		x->width = sh;
+		x->height = sw;
+	} else {
+		x0 = 0;
+		xdx = 1;
+		xdy = 0;
+		y0 = 0;
+		ydx = 0;
+		ydy = 1;
+		x->width = sw;
+		x->height = sh;
+	}
+
+	if (item->flags & SDE_ROTATION_FLIP_LR) {
+		x0 = sw - 1 - x0;
+		xdx = -xdx;
+		xdy = -xdy;
+	}
+
+	if (item->flags & SDE_ROTATION_FLIP_UD) {
+		y0 = sh - 1 - y0;
+		ydx = -ydx;
+		ydy = -ydy;
+	}
+
+	x->cpp = cpp;
+	x->src = src->vaddr[plane] +
+		(ssize_t)(item->src_rect.y / sub + y0) * sstride +
+		(ssize_t)(item->src_rect.x / sub + x0) * cpp;
+	x->src_dx = ydx * sstride + xdx * (ssize_t)cpp;
+	x->src_dy = ydy * sstride + xdy * (ssize_t)cpp;
+	x->dst_stride = dst->stride[plane];
+	x->dst = dst->vaddr[plane] +
+		(ssize_t)(item->dst_rect.y / sub) * x->dst_stride +
+		(ssize_t)(item->dst_rect.x / sub) * cpp;
+}
+
+/*
+ * sde_rot_sw_unmap_buf - release the cpu mapping of a rotator buffer
+ * @buf: Pointer to buffer mapping
+ * @dir: dma direction the buffer was accessed with
+ */
+static void sde_rot_sw_unmap_buf(struct sde_rot_sw_buf *buf,
+		enum dma_data_direction dir)
+{
+	int i;
+
+	for (i = 0; i < buf->num_planes; i++) {
+		if (!buf->dmabuf[i])
+			continue;
+
+		dma_buf_vunmap(buf->dmabuf[i], &buf->map[i]);
+		dma_buf_end_cpu_access(buf->dmabuf[i], dir);
+		buf->dmabuf[i] = NULL;
+	}
+
+	buf->num_planes = 0;
+}
+
+/*
+ * sde_rot_sw_map_buf - map a rotator buffer for cpu access
+ * @data: Pointer to rotator buffer
+ * @layer: Pointer to layer description of the buffer
+ * @fmt: Pointer to format of the buffer
+ * @dir: dma direction of the access
+ * @buf: Pointer to buffer mapping to fill
+ *
+ * Planes sharing one dma-buf were split by sde_mdp_data_check(), walk the
+ * same plane layout here to locate them in the kernel mapping. Every plane
+ * must lie within its dma-buf, the cpu access is not contained by the smmu.
+ */
+static int sde_rot_sw_map_buf(struct sde_mdp_data *data,
+		struct sde_layer_buffer *layer,
+		struct sde_mdp_format_params *fmt,
+		enum dma_data_direction dir, struct sde_rot_sw_buf *buf)
+{
+	struct sde_mdp_plane_sizes ps;
+	struct dma_buf *dmabuf;
+	u64 end = 0, limit = 0;
+	int i, ret;
+
+	ret = sde_mdp_get_plane_sizes(fmt, layer->width, layer->height,
+			&ps, 0, false);
+	if (ret)
+		return ret;
+
+	if (data->num_planes < ps.num_planes || !data->p[0].srcp_dma_buf)
+		return -EINVAL;
+
+	memset(buf, 0, sizeof(*buf));
+
+	for (i = 0; i < ps.num_planes; i++) {
+		dmabuf = data->p[i].srcp_dma_buf;
+		buf->stride[i] = ps.ystride[i];
+		buf->num_planes = i + 1;
+
+		if (dmabuf) {
+			end = data->p[i].offset;
+			limit = dmabuf->size;
+		}
+
+		end += ps.plane_size[i];
+		if (end > limit) {
+			SDEROT_DBG("plane %d exceeds dma-buf size %llu\n", i,
+					limit);
+			ret = -EINVAL;
+			goto error;
+		}
+
+		if (!dmabuf) {
+			buf->vaddr[i] = buf->vaddr[i - 1] + ps.plane_size[i - 1];
+			continue;
+		}
+
+		ret = dma_buf_begin_cpu_access(dmabuf, dir);
+		if (ret)
+			goto error;
+
+		ret = dma_buf_vmap(dmabuf, &buf->map[i]);
+		if (ret || !buf->map[i].vaddr) {
+			dma_buf_end_cpu_access(dmabuf, dir);
+			ret = ret ? ret : -ENOMEM;
+			goto error;
+		}
+
+		buf->dmabuf[i] = dmabuf;
+		buf->vaddr[i] = (u8 *)buf->map[i].vaddr + data->p[i].offset;
+	}
+
+	for (i = 0; i < buf->num_planes; i++) {
+		if (!IS_ALIGNED((unsigned long)buf->vaddr[i], fmt->bpp) ||
+				!IS_ALIGNED(buf->stride[i], fmt->bpp)) {
+			SDEROT_DBG("unaligned plane %d\n", i);
+			ret = -EINVAL;
+			goto error;
+		}
+	}
+
+	return 0;
+error:
+	sde_rot_sw_unmap_buf(buf, dir);
+	return ret;
+}
+
+/*
+ * sde_rot_sw_rotate - rotate one entry on the cpu
+ * @entry: Pointer to rotation entry
+ * @bytes: Pointer to return the number of output bytes written
+ */
+static int sde_rot_sw_rotate(struct sde_rot_entry *entry, u64 *bytes)
+{
+	struct sde_rotation_item *item = &entry->item;
+	struct sde_mdp_format_params *fmt;
+	struct sde_rot_sw_buf src, dst;
+	struct sde_rot_sw_xfrm x;
+	int ret;
+
+	fmt = sde_get_format_params(item->input.format);
+	if (!fmt)
+		return -EINVAL;
+
+	ret = sde_rot_sw_map_buf(&entry->src_buf, &item->input, fmt,
+			DMA_FROM_DEVICE, &src);
+	if (ret) {
+		SDEROT_ERR("fail to map input buffer %d\n", ret);
+		return ret;
+	}
+
+	ret = sde_rot_sw_map_buf(&entry->dst_buf, &item->output, fmt,
+			DMA_TO_DEVICE, &dst);
+	if (ret) {
+		SDEROT_ERR("fail to map output buffer %d\n", ret);
+		goto error_dst;
+	}
+
+	*bytes = 0;
+	if (sde_mdp_is_yuv_format(fmt)) {
+		sde_rot_sw_setup_xfrm(item, &src, &dst, 0, 1, 1, &x);
+		sde_rot_sw_xfrm_plane(&x);
+		*bytes += (u64)x.width * x.height;
+
+		sde_rot_sw_setup_xfrm(item, &src, &dst, 1, 2, 2, &x);
+		sde_rot_sw_xfrm_plane(&x);
+		*bytes += (u64)x.width * x.height * x.cpp;
+	} else {
+		sde_rot_sw_setup_xfrm(item, &src, &dst, 0, 1, fmt->bpp, &x);
+		sde_rot_sw_xfrm_plane(&x);
+		*bytes += (u64)x.width * x.height * x.cpp;
+	}
+
+	sde_rot_sw_unmap_buf(&dst, DMA_TO_DEVICE);
+error_dst:
+	sde_rot_sw_unmap_buf(&src, DMA_FROM_DEVICE);
+	return ret;
+}
+
+static struct sde_rot_hw_resource *sde_rot_sw_alloc_ext(
+	struct sde_rot_mgr *mgr, u32 pipe_id, u32 wb_id)
+{
+	struct sde_rot_sw_resource *res;
+
+	if (!mgr || !mgr->hw_data) {
+		SDEROT_ERR("null parameters\n");
+		return NULL;
+	}
+
+	res = devm_kzalloc(&mgr->pdev->dev, sizeof(*res), GFP_KERNEL);
+	if (!res)
+		return NULL;
+
+	res->hw.wb_id = wb_id;
+	res->hw.max_active = 1;
+	atomic_set(&res->hw.num_active, 0);
+	init_waitqueue_head(&res->hw.wait_queue);
+
+	SDEROT_DBG("New sw rotator resource:%pK, priority:%d\n", res, wb_id);
+
+	return &res->hw;
+}
+
+static void sde_rot_sw_free_ext(struct sde_rot_mgr *mgr,
+	struct sde_rot_hw_resource *hw)
+{
+	struct sde_rot_sw_resource *res;
+
+	if (!mgr || !hw)
+		return;
+
+	res = container_of(hw, struct sde_rot_sw_resource, hw);
+	devm_kfree(&mgr->pdev->dev, res);
+}
+
+static int sde_rot_sw_config_hw(struct sde_rot_hw_resource *hw,
+	struct sde_rot_entry *entry)
+{
+	return 0;
+}
+
+static int sde_rot_sw_cancel_hw(struct sde_rot_hw_resource *hw,
+	struct sde_rot_entry *entry)
+{
+	return 0;
+}
+
+static int sde_rot_sw_abort_hw(struct sde_rot_hw_resource *hw,
+	struct sde_rot_entry *entry)
+{
+	return 0;
+}
+
+static int sde_rot_sw_kickoff_entry(struct sde_rot_hw_resource *hw,
+	struct sde_rot_entry *entry)
+{
+	return 0;
+}
+
+/*
+ * sde_rot_sw_wait_for_entry - process the entry on the cpu
+ * @hw: Pointer to queue resource
+ * @entry: Pointer to rotation entry
+ *
+ * The copy runs from the done queue worker rather than at kickoff, so the
+ * commit worker is released as soon as the entry is queued and the copy
+ * does not hold the manager lock.
+ */
+static int sde_rot_sw_wait_for_entry(struct sde_rot_hw_resource *hw,
+	struct sde_rot_entry *entry)
+{
+	struct sde_rot_sw_resource *res;
+	ktime_t start;
+	u64 bytes = 0;
+	int ret;
+
+	if (!hw || !entry) {
+		SDEROT_ERR("null hw resource/entry\n");
+		return -EINVAL;
+	}
+
+	res = container_of(hw, struct sde_rot_sw_resource, hw);
+
+	start = ktime_get();
+	ret = sde_rot_sw_rotate(entry, &bytes);
+
+	res->count++;
+	res->time_us += ktime_us_delta(ktime_get(), start);
+	if (ret)
+		res->failed++;
+	else
+		res->bytes += bytes;
+
+	return ret;
+}
+
+static int sde_rot_sw_validate_entry(struct sde_rot_mgr *mgr,
+	struct sde_rot_entry *entry)
+{
+	struct sde_rotation_item *item = &entry->item;
+	struct sde_mdp_format_params *fmt;
+	u32 dst_w, dst_h;
+
+	entry->dnsc_factor_w = 0;
+	entry->dnsc_factor_h = 0;
+
+	if (item->flags & (SDE_ROTATION_SECURE | SDE_ROTATION_SECURE_CAMERA |
+			SDE_ROTATION_DEINTERLACE)) {
+		SDEROT_DBG("unsupported flags 0x%x\n", item->flags);
+		return -EINVAL;
+	}
+
+	if (entry->dst_buf.sbuf) {
+		SDEROT_DBG("stream buffer not supported\n");
+		return -EINVAL;
+	}
+
+	if (item->input.format != item->output.format) {
+		SDEROT_DBG("format conversion not supported\n");
+		return -EINVAL;
+	}
+
+	fmt = sde_get_format_params(item->input.format);
+	if (!fmt || !sde_mdp_is_linear_format(fmt)) {
+		SDEROT_DBG("unsupported format 0x%x\n", item->input.format);
+		return -EINVAL;
+	}
+
+	if (item->flags & SDE_ROTATION_90) {
+		dst_w = item->dst_rect.h;
+		dst_h = item->dst_rect.w;
+	} else {
+		dst_w = item->dst_rect.w;
+		dst_h = item->dst_rect.h;
+	}
+
+	if ((item->src_rect.w != dst_w) || (item->src_rect.h != dst_h)) {
+		SDEROT_DBG("scaling not supported\n");
+		return -EINVAL;
+	}
+
+	/* the cpu copy is not contained by the smmu, keep it in bounds */
+	if ((u64)item->src_rect.x + item->src_rect.w > item->input.width ||
+			(u64)item->src_rect.y + item->src_rect.h >
+			item->input.height ||
+			(u64)item->dst_rect.x + item->dst_rect.w >
+			item->output.width ||
+			(u64)item->dst_rect.y + item->dst_rect.h >
+			item->output.height) {
+		SDEROT_DBG("rectangle exceeds buffer\n");
+		return -EINVAL;
+	}
+
+	if (sde_mdp_is_yuv_format(fmt) &&
+			((item->src_rect.x | item->src_rect.y |
+			  item->src_rect.w | item->src_rect.h |
+			  item->dst_rect.x | item->dst_rect.y) & 1)) {
+		SDEROT_DBG("odd yuv rectangle not supported\n");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static ssize_t sde_rot_sw_show_caps(struct sde_rot_mgr *mgr,
+		struct device_attribute *attr, char *buf, ssize_t len)
+{
+	int cnt = 0;
+
+	if (!mgr || !buf)
+		return 0;
+
+#define SPRINT(fmt, ...) \
+		(cnt += scnprintf(buf + cnt, len - cnt, fmt, ##__VA_ARGS__))
+
+	SPRINT("sw_rotator=1\n");
+	SPRINT("tile=%d\n", SDE_ROT_SW_TILE);
+	return cnt;
+}
+
+static ssize_t sde_rot_sw_show_state(struct sde_rot_mgr *mgr,
+		struct device_attribute *attr, char *buf, ssize_t len)
+{
+	struct sde_rot_sw_resource *res;
+	int cnt = 0;
+	int i;
+
+	if (!mgr || !buf)
+		return 0;
+
+#define SPRINT(fmt, ...) \
+		(cnt += scnprintf(buf + cnt, len - cnt, fmt, ##__VA_ARGS__))
+
+	for (i = 0; i < mgr->queue_count; i++) {
+		if (!mgr->commitq || !mgr->commitq[i].hw)
+			continue;
+
+		res = container_of(mgr->commitq[i].hw,
+				struct sde_rot_sw_resource, hw);
+		SPRINT("sw%d: count=%llu failed=%llu bytes=%llu time_us=%llu\n",
+				i, res->count, res->failed, res->bytes,
+				res->time_us);
+	}
+
+	return cnt;
+}
+
+/*
+ * sde_rot_sw_get_pixfmt - get the indexed pixel format
+ * @mgr: Pointer to rotator manager
+ * @index: index of pixel format
+ * @input: true for input port; false for output port
+ * @mode: operating mode
+ */
+static u32 sde_rot_sw_get_pixfmt(struct sde_rot_mgr *mgr,
+		int index, bool input, u32 mode)
+{
+	if (mode != SDE_ROTATOR_MODE_OFFLINE)
+		return 0;
+
+	if (index < ARRAY_SIZE(sde_rot_sw_pixfmts))
+		return sde_rot_sw_pixfmts[index];
+
+	return 0;
+}
+
+/*
+ * sde_rot_sw_is_valid_pixfmt - verify if the given pixel format is valid
+ * @mgr: Pointer to rotator manager
+ * @pixfmt: pixel format to be verified
+ * @input: true for input port; false for output port
+ * @mode: operating mode
+ */
+static int sde_rot_sw_is_valid_pixfmt(struct sde_rot_mgr *mgr, u32 pixfmt,
+		bool input, u32 mode)
+{
+	int i;
+
+	if (mode != SDE_ROTATOR_MODE_OFFLINE)
+		return false;
+
+	for (i = 0; i < ARRAY_SIZE(sde_rot_sw_pixfmts); i++)
+		if (sde_rot_sw_pixfmts[i] == pixfmt)
+			return true;
+
+	return false;
+}
+
+static void sde_rot_sw_destroy(struct sde_rot_mgr *mgr)
+{
+	if (!mgr || !mgr->pdev || !mgr->hw_data)
+		return;
+
+	devm_kfree(&mgr->pdev->dev, mgr->hw_data);
+	mgr->hw_data = NULL;
+}
+
+/*
+ * sde_rotator_sw_init - initialize the software rotator backend
+ * @mgr: Pointer to rotator manager
+ *
+ * Rotates and flips linear RGB and pseudo planar YUV 4:2:0 buffers on the
+ * cpu, for targets without a usable rotator block. Format conversion,
+ * scaling, secure and inline sessions are not supported.
+ */
+int sde_rotator_sw_init(struct sde_rot_mgr *mgr)
+{
+	struct sde_rot_sw_data *hw_data;
+
+	if (!mgr || !mgr->pdev) {
+		SDEROT_ERR("null rotator manager/platform device");
+		return -EINVAL;
+	}
+
+	hw_data = devm_kzalloc(&mgr->pdev->dev, sizeof(*hw_data), GFP_KERNEL);
+	if (!hw_data)
+		return -ENOMEM;
+
+	hw_data->mgr = mgr;
+
+	mgr->hw_data = hw_data;
+	mgr->ops_config_hw = sde_rot_sw_config_hw;
+	mgr->ops_cancel_hw = sde_rot_sw_cancel_hw;
+	mgr->ops_abort_hw = sde_rot_sw_abort_hw;
+	mgr->ops_kickoff_entry = sde_rot_sw_kickoff_entry;
+	mgr->ops_wait_for_entry = sde_rot_sw_wait_for_entry;
+	mgr->ops_hw_alloc = sde_rot_sw_alloc_ext;
+	mgr->ops_hw_free = sde_rot_sw_free_ext;
+	mgr->ops_hw_destroy = sde_rot_sw_destroy;
+	mgr->ops_hw_validate_entry = sde_rot_sw_validate_entry;
+	mgr->ops_hw_show_caps = sde_rot_sw_show_caps;
+	mgr->ops_hw_show_state = sde_rot_sw_show_state;
+	mgr->ops_hw_get_pixfmt = sde_rot_sw_get_pixfmt;
+	mgr->ops_hw_is_valid_pixfmt = sde_rot_sw_is_valid_pixfmt;
+
+	SDEROT_INFO("software rotator enabled\n");
+
+	return 0;
+}
@@ -0,0 +1,15 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
+ */
+
+#ifndef __SDE_ROTATOR_SW_H__
+#define __SDE_ROTATOR_SW_H__
+
+#include <linux/types.h>
+
+#include "sde_rotator_core.h"
+
+int sde_rotator_sw_init(struct sde_rot_mgr *mgr);
+
+#endif /* __SDE_ROTATOR_SW_H__ */
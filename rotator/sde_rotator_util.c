@@ -774,6 +774,262 @@ static int sde_mdp_is_map_needed(struct sde_mdp_img_data *data)
 	return true;
 }
 
+#define SDE_MDP_BUF_CACHE_MAX_DEFAULT	32
+
+/*
+ * struct sde_mdp_buf_cache_entry - cached dma-buf attachment and mapping
+ * @list: link in the cache lru list, most recently used first
+ * @dma_buf: cached dma-buf, the cache holds its own reference on it
+ * @attachment: attachment of @dma_buf to the smmu context bank device
+ * @table: mapped scatter list table of @attachment
+ * @len: total length of @table
+ * @domain: smmu domain type of @attachment
+ * @dir: dma direction of the mapping
+ * @owner: session the mapping belongs to, NULL once that session closed
+ * @users: number of image data currently using this mapping
+ */
+struct sde_mdp_buf_cache_entry {
+	struct list_head list;
+	struct dma_buf *dma_buf;
+	struct dma_buf_attachment *attachment;
+	struct sg_table *table;
+	unsigned long len;
+	u32 domain;
+	int dir;
+	void *owner;
+	u32 users;
+};
+
+/*
+ * Video pipelines cycle through a small pool of buffers, so keep the
+ * attachment and mapping of recently used buffers instead of attaching
+ * and mapping them again on every request.
+ */
+static struct sde_mdp_buf_cache {
+	struct mutex lock;
+	struct list_head lru;
+	struct sde_mdp_buf_cache_stats stats;
+} sde_mdp_buf_cache = {
+	.lock = __MUTEX_INITIALIZER(sde_mdp_buf_cache.lock),
+	.lru = LIST_HEAD_INIT(sde_mdp_buf_cache.lru),
+	.stats.max_count = SDE_MDP_BUF_CACHE_MAX_DEFAULT,
+};
+
+static bool sde_mdp_buf_cache_enabled(struct sde_mdp_img_data *data,
+		u32 domain)
+{
+	return READ_ONCE(sde_mdp_buf_cache.stats.max_count) &&
+		data->cache_owner && !IS_ERR_OR_NULL(data->srcp_dma_buf) &&
+		sde_mdp_is_map_needed(data) &&
+		domain == SDE_IOMMU_DOMAIN_ROT_UNSECURE;
+}
+
+/* caller must hold the cache lock, and the entry must be idle */
+static void sde_mdp_buf_cache_free(struct sde_mdp_buf_cache_entry *entry)
+{
+	SDEROT_DBG("drop cached buf:%pK d:%u dir:%d\n", entry->dma_buf,
+			entry->domain, entry->dir);
+
+	list_del(&entry->list);
+	sde_mdp_buf_cache.stats.count--;
+
+	entry->attachment->dma_map_attrs |= DMA_ATTR_DELAYED_UNMAP;
+	dma_buf_unmap_attachment(entry->attachment, entry->table, entry->dir);
+	dma_buf_detach(entry->dma_buf, entry->attachment);
+	dma_buf_put(entry->dma_buf);
+	kfree(entry);
+}
+
+/* the buffer is released once the cache holds its only reference */
+static bool sde_mdp_buf_cache_released(struct sde_mdp_buf_cache_entry *entry)
+{
+	return file_count(entry->dma_buf->file) == 1;
+}
+
+/*
+ * Drop idle entries, least recently used first, whose buffer has been
+ * released by everyone else or which exceed the cache size, or all idle
+ * entries on flush. Caller must hold the cache lock.
+ */
+static void sde_mdp_buf_cache_shrink(bool flush)
+{
+	struct sde_mdp_buf_cache *cache = &sde_mdp_buf_cache;
+	struct sde_mdp_buf_cache_entry *entry, *tmp;
+
+	list_for_each_entry_safe_reverse(entry, tmp, &cache->lru, list) {
+		if (entry->users)
+			continue;
+
+		if (sde_mdp_buf_cache_released(entry)) {
+			cache->stats.releases++;
+		} else if (flush ||
+				cache->stats.count > cache->stats.max_count) {
+			cache->stats.evictions++;
+		} else {
+			continue;
+		}
+
+		sde_mdp_buf_cache_free(entry);
+	}
+}
+
+static struct sde_mdp_buf_cache_entry *sde_mdp_buf_cache_get(
+		struct dma_buf *dma_buf, u32 domain, int dir, void *owner)
+{
+	struct sde_mdp_buf_cache *cache = &sde_mdp_buf_cache;
+	struct sde_mdp_buf_cache_entry *entry;
+
+	mutex_lock(&cache->lock);
+	list_for_each_entry(entry, &cache->lru, list) {
+		if (entry->dma_buf == dma_buf && entry->domain == domain &&
+				entry->dir == dir && entry->owner == owner) {
+			entry->users++;
+			list_move(&entry->list, &cache->lru);
+			cache->stats.hits++;
+			mutex_unlock(&cache->lock);
+			return entry;
+		}
+	}
+	cache->stats.misses++;
+	mutex_unlock(&cache->lock);
+
+	return NULL;
+}
+
+/*
+ * sde_mdp_buf_cache_add - hand over a new mapping to the cache
+ * @data: image data holding a valid attachment and mapping
+ * @domain: smmu domain type of the attachment
+ * @dir: dma direction of the mapping
+ *
+ * On allocation failure the mapping simply stays private to @data.
+ */
+static void sde_mdp_buf_cache_add(struct sde_mdp_img_data *data,
+		u32 domain, int dir)
+{
+	struct sde_mdp_buf_cache *cache = &sde_mdp_buf_cache;
+	struct sde_mdp_buf_cache_entry *entry;
+
+	entry = kzalloc(sizeof(*entry), GFP_KERNEL);
+	if (!entry)
+		return;
+
+	get_dma_buf(data->srcp_dma_buf);
+	entry->dma_buf = data->srcp_dma_buf;
+	entry->attachment = data->srcp_attachment;
+	entry->table = data->srcp_table;
+	entry->len = data->len;
+	entry->domain = domain;
+	entry->dir = dir;
+	entry->owner = data->cache_owner;
+	entry->users = 1;
+	data->cache = entry;
+
+	mutex_lock(&cache->lock);
+	list_add(&entry->list, &cache->lru);
+	cache->stats.count++;
+	sde_mdp_buf_cache_shrink(false);
+	mutex_unlock(&cache->lock);
+}
+
+static void sde_mdp_buf_cache_put(struct sde_mdp_img_data *data, int dir)
+{
+	struct sde_mdp_buf_cache *cache = &sde_mdp_buf_cache;
+	struct sde_mdp_buf_cache_entry *entry = data->cache;
+
+	/* the mapping stays alive, do the cpu sync an unmap would have done */
+	if (!(entry->attachment->dma_map_attrs & DMA_ATTR_SKIP_CPU_SYNC) &&
+			dir != DMA_TO_DEVICE)
+		dma_sync_sg_for_cpu(entry->attachment->dev, entry->table->sgl,
+				entry->table->orig_nents, dir);
+
+	mutex_lock(&cache->lock);
+	entry->users--;
+	if (!entry->users && (!entry->owner ||
+			sde_mdp_buf_cache_released(entry))) {
+		cache->stats.releases++;
+		sde_mdp_buf_cache_free(entry);
+	} else if (!entry->users &&
+			cache->stats.count > cache->stats.max_count) {
+		cache->stats.evictions++;
+		sde_mdp_buf_cache_free(entry);
+	}
+	mutex_unlock(&cache->lock);
+
+	data->cache = NULL;
+}
+
+/*
+ * sde_mdp_buf_cache_get_stats - get snapshot of mapping cache statistics
+ * @stats: Pointer to statistics to fill in
+ */
+void sde_mdp_buf_cache_get_stats(struct sde_mdp_buf_cache_stats *stats)
+{
+	mutex_lock(&sde_mdp_buf_cache.lock);
+	*stats = sde_mdp_buf_cache.stats;
+	mutex_unlock(&sde_mdp_buf_cache.lock);
+}
+
+/*
+ * sde_mdp_buf_cache_set_max - resize mapping cache and reset its statistics
+ * @max_count: maximum number of idle cached mappings, 0 disables the cache
+ */
+void sde_mdp_buf_cache_set_max(u32 max_count)
+{
+	struct sde_mdp_buf_cache *cache = &sde_mdp_buf_cache;
+
+	sde_smmu_ctrl(1);
+	mutex_lock(&cache->lock);
+	cache->stats.max_count = max_count;
+	sde_mdp_buf_cache_shrink(false);
+	cache->stats.hits = 0;
+	cache->stats.misses = 0;
+	cache->stats.evictions = 0;
+	cache->stats.releases = 0;
+	mutex_unlock(&cache->lock);
+	sde_smmu_ctrl(0);
+}
+
+/*
+ * sde_mdp_buf_cache_release - drop all mappings owned by a session
+ * @owner: session the mappings were cached for
+ *
+ * Idle mappings are dropped right away, mappings still in use are
+ * orphaned and dropped when their last user puts them.
+ */
+void sde_mdp_buf_cache_release(void *owner)
+{
+	struct sde_mdp_buf_cache *cache = &sde_mdp_buf_cache;
+	struct sde_mdp_buf_cache_entry *entry, *tmp;
+
+	sde_smmu_ctrl(1);
+	mutex_lock(&cache->lock);
+	list_for_each_entry_safe(entry, tmp, &cache->lru, list) {
+		if (entry->owner != owner)
+			continue;
+
+		entry->owner = NULL;
+		if (!entry->users) {
+			cache->stats.releases++;
+			sde_mdp_buf_cache_free(entry);
+		}
+	}
+	mutex_unlock(&cache->lock);
+	sde_smmu_ctrl(0);
+}
+
+/*
+ * sde_mdp_buf_cache_flush - drop all idle mappings
+ */
+void sde_mdp_buf_cache_flush(void)
+{
+	sde_smmu_ctrl(1);
+	mutex_lock(&sde_mdp_buf_cache.lock);
+	sde_mdp_buf_cache_shrink(true);
+	mutex_unlock(&sde_mdp_buf_cache.lock);
+	sde_smmu_ctrl(0);
+}
+
 static int sde_mdp_put_img(struct sde_mdp_img_data *data, bool rotator,
 		int dir)
 {
@@ -796,16 +1052,21 @@ static int sde_mdp_put_img(struct sde_mdp_img_data *data, bool rotator,
 					data->len, domain, data->flags);
 		}
 		if (!data->skip_detach) {
-			data->srcp_attachment->dma_map_attrs |=
-				DMA_ATTR_DELAYED_UNMAP;
-			dma_buf_unmap_attachment(data->srcp_attachment,
-				data->srcp_table, dir);
-			dma_buf_detach(data->srcp_dma_buf,
-					data->srcp_attachment);
+			if (!data->cache) {
+				data->srcp_attachment->dma_map_attrs |=
+					DMA_ATTR_DELAYED_UNMAP;
+				dma_buf_unmap_attachment(data->srcp_attachment,
+					data->srcp_table, dir);
+				dma_buf_detach(data->srcp_dma_buf,
+						data->srcp_attachment);
+			}
 			if (!(data->flags & SDE_ROT_EXT_DMA_BUF)) {
 				dma_buf_put(data->srcp_dma_buf);
 				data->srcp_dma_buf = NULL;
 			}
+			/* after our own put, so a released buffer is seen */
+			if (data->cache)
+				sde_mdp_buf_cache_put(data, dir);
 			data->skip_detach = true;
 		}
 	} else {
@@ -824,6 +1085,7 @@ static int sde_mdp_get_img(struct sde_fb_data *img,
 
 	data->flags |= img->flags;
 	data->offset = img->offset;
+	data->cache = NULL;
 	if (data->flags & SDE_ROT_EXT_DMA_BUF) {
 		data->srcp_dma_buf = img->buffer;
 	} else if (data->flags & SDE_ROT_EXT_IOVA) {
@@ -843,9 +1105,15 @@ static int sde_mdp_get_img(struct sde_fb_data *img,
 
 		SDEROT_DBG("%d domain=%d ihndl=%pK\n",
 				__LINE__, domain, data->srcp_dma_buf);
-		data->srcp_attachment =
-			sde_smmu_dma_buf_attach(data->srcp_dma_buf, dev,
-					domain);
+		if (sde_mdp_buf_cache_enabled(data, domain))
+			data->cache = sde_mdp_buf_cache_get(data->srcp_dma_buf,
+					domain, dir, data->cache_owner);
+		if (data->cache)
+			data->srcp_attachment = data->cache->attachment;
+		else
+			data->srcp_attachment =
+				sde_smmu_dma_buf_attach(data->srcp_dma_buf,
+						dev, domain);
 		if (IS_ERR(data->srcp_attachment)) {
 			SDEROT_ERR("%d Failed to attach dma buf\n", __LINE__);
 			ret = PTR_ERR(data->srcp_attachment);
@@ -886,6 +1154,7 @@ static int sde_mdp_map_buffer(struct sde_mdp_img_data *data, bool rotator,
 	struct sg_table *sgt = NULL;
 	unsigned int i;
 	unsigned long flags = 0;
+	u32 domain;
 
 	if (data->addr && data->len)
 		return 0;
@@ -896,7 +1165,20 @@ static int sde_mdp_map_buffer(struct sde_mdp_img_data *data, bool rotator,
 		return 0;
 	}
 
-	if (!IS_ERR_OR_NULL(data->srcp_dma_buf)) {
+	if (!IS_ERR_OR_NULL(data->srcp_dma_buf) && data->cache) {
+		/* cached mapping, only the cache maintenance is needed */
+		sgt = data->cache->table;
+		if (!(data->srcp_attachment->dma_map_attrs &
+				DMA_ATTR_SKIP_CPU_SYNC))
+			dma_sync_sg_for_device(data->srcp_attachment->dev,
+					sgt->sgl, sgt->orig_nents, dir);
+
+		data->srcp_table = sgt;
+		data->len = data->cache->len;
+		data->addr = sgt->sgl->dma_address;
+		data->mapped = true;
+		ret = 0;
+	} else if (!IS_ERR_OR_NULL(data->srcp_dma_buf)) {
 		/*
 		 * dma_buf_map_attachment will call into
 		 * dma_map_sg_attrs, and so all cache maintenance
@@ -942,6 +1224,11 @@ static int sde_mdp_map_buffer(struct sde_mdp_img_data *data, bool rotator,
 					data->flags);
 			data->mapped = true;
 			ret = 0;
+
+			domain = sde_smmu_get_domain_type(data->flags,
+					rotator);
+			if (sde_mdp_buf_cache_enabled(data, domain))
+				sde_mdp_buf_cache_add(data, domain, dir);
 		} else {
 			if (sgt->nents != 1) {
 				SDEROT_ERR(
@@ -1005,6 +1292,7 @@ static int sde_mdp_data_get(struct sde_mdp_data *data,
 
 	for (i = 0; i < num_planes; i++) {
 		data->p[i].flags = flags;
+		data->p[i].cache_owner = data->owner;
 		rc = sde_mdp_get_img(&planes[i], &data->p[i], dev, rotator,
 				dir);
 		if (rc) {
@@ -143,6 +143,8 @@ struct sde_mdp_plane_sizes {
 	u32 rau_h[2];
 };
 
+struct sde_mdp_buf_cache_entry;
+
 struct sde_mdp_img_data {
 	dma_addr_t addr;
 	unsigned long len;
@@ -154,6 +156,26 @@ struct sde_mdp_img_data {
 	struct dma_buf *srcp_dma_buf;
 	struct dma_buf_attachment *srcp_attachment;
 	struct sg_table *srcp_table;
+	struct sde_mdp_buf_cache_entry *cache;
+	void *cache_owner;
+};
+
+/*
+ * struct sde_mdp_buf_cache_stats - dma-buf mapping cache statistics
+ * @count: number of cached mappings
+ * @max_count: maximum number of idle cached mappings, 0 disables the cache
+ * @hits: number of buffer lookups served from the cache
+ * @misses: number of buffer lookups which needed a new attach and map
+ * @evictions: number of idle mappings evicted to honor @max_count
+ * @releases: number of mappings dropped on buffer release or session close
+ */
+struct sde_mdp_buf_cache_stats {
+	u32 count;
+	u32 max_count;
+	u64 hits;
+	u64 misses;
+	u64 evictions;
+	u64 releases;
 };
 
 struct sde_mdp_data {
@@ -162,6 +184,7 @@ struct sde_mdp_data {
 	bool sbuf;
 	int scid;
 	bool writeback;
+	void *owner;
 };
 
 void sde_mdp_get_v_h_subsample_rate(u8 chroma_sample,
@@ -196,4 +219,12 @@ int sde_mdp_data_check(struct sde_mdp_data *data,
 void sde_mdp_data_free(struct sde_mdp_data *data, bool rotator, int dir);
 
 struct dma_buf *sde_rot_get_dmabuf(struct sde_mdp_img_data *data);
+
+void sde_mdp_buf_cache_get_stats(struct sde_mdp_buf_cache_stats *stats);
+
+void sde_mdp_buf_cache_set_max(u32 max_count);
+
+void sde_mdp_buf_cache_release(void *owner);
+
+void sde_mdp_buf_cache_flush(void);
 #endif /* __SDE_ROTATOR_UTIL_H__ */